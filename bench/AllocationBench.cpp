@@ -0,0 +1,347 @@
+// Counts heap allocations per request on the client side.
+//
+// The same file is built twice: allocationBench_baseline against HttpClient
+// and ObjectApi taken from git at NETWORKING_BENCH_BASELINE, and
+// allocationBench_current against src/. Only API both share is used. A
+// loopback HTTP server in its own thread answers every request with the same
+// small JSON object; its allocations are not counted, everything else is
+// (HttpClient, QNetworkAccessManager including its own threads, callbacks,
+// JSON parsing).
+//
+// malloc/calloc/realloc and the aligned variants are interposed, so Qt's
+// containers (QArrayData goes straight to ::malloc) are counted as well as
+// operator new. glibc only.
+//
+//   cmake -S . -B build -DNETWORKING_BUILD_BENCH=ON
+//   cmake --build build --target allocationBench   (runs both, baseline first)
+//   ./build/allocationBench_current [requests]
+
+#include <QCoreApplication>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkProxy>
+#include <QRestReply>
+#include <QSemaphore>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+
+#include "ApiTypes.h"
+#include "HttpClient.h"
+#include "ObjectApi.h"
+
+#ifndef __GLIBC__
+#error "AllocationBench interposes malloc through glibc's __libc_* entry points"
+#endif
+
+// ---- allocation counter --------------------------------------------------
+
+namespace {
+
+std::atomic<quint64> g_allocations{0}; // malloc, calloc, aligned
+std::atomic<quint64> g_reallocations{0};
+std::atomic<quint64> g_bytes{0};       // requested, not resident
+
+// Set on the server thread and around the driver's own bookkeeping
+thread_local bool t_untracked = false;
+
+inline void countAllocation(std::size_t size)
+{
+    if (t_untracked) return;
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+class Untracked
+{
+public:
+    Untracked() : m_previous(t_untracked) { t_untracked = true; }
+    ~Untracked() { t_untracked = m_previous; }
+
+private:
+    bool m_previous;
+};
+
+struct Counts {
+    quint64 allocations = 0;
+    quint64 reallocations = 0;
+    quint64 bytes = 0;
+
+    static Counts now()
+    {
+        return { g_allocations.load(), g_reallocations.load(), g_bytes.load() };
+    }
+};
+
+} // namespace
+
+extern "C" {
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+void* __libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(std::size_t size) noexcept
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept
+{
+    if (!t_untracked) {
+        g_reallocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) noexcept
+{
+    __libc_free(ptr);
+}
+
+void* memalign(std::size_t alignment, std::size_t size) noexcept
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t size) noexcept
+{
+    countAllocation(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** out, std::size_t alignment, std::size_t size) noexcept
+{
+    countAllocation(size);
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) return ENOMEM;
+    *out = ptr;
+    return 0;
+}
+
+} // extern "C"
+
+// ---- loopback server -----------------------------------------------------
+
+namespace {
+
+// Keep-alive HTTP/1.1, one canned 200 for every request
+class BenchServer : public QThread
+{
+public:
+    quint16 start()
+    {
+        QThread::start();
+        m_ready.acquire();
+        return m_port;
+    }
+
+protected:
+    void run() override
+    {
+        t_untracked = true;
+
+        const QByteArray body = R"({"id":"7","name":"Apple MacBook Pro 16","data":{"year":2019}})";
+        const QByteArray response = "HTTP/1.1 200 OK\r\n"
+                                    "Content-Type: application/json\r\n"
+                                    "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                                    "\r\n" + body;
+
+        QTcpServer server;
+        server.listen(QHostAddress::LocalHost);
+        m_port = server.serverPort();
+
+        QObject::connect(&server, &QTcpServer::newConnection, &server, [&server, &response]() {
+            while (QTcpSocket* socket = server.nextPendingConnection()) {
+                auto buffer = std::make_shared<QByteArray>();
+                QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket, buffer, &response]() {
+                    buffer->append(socket->readAll());
+                    for (;;) {
+                        const qsizetype headerEnd = buffer->indexOf("\r\n\r\n");
+                        if (headerEnd < 0) return;
+
+                        qsizetype bodyLength = 0;
+                        for (const QByteArray& line : buffer->left(headerEnd).split('\n')) {
+                            if (line.toLower().startsWith("content-length:"))
+                                bodyLength = line.mid(15).trimmed().toLongLong();
+                        }
+
+                        const qsizetype requestLength = headerEnd + 4 + bodyLength;
+                        if (buffer->size() < requestLength) return;
+                        buffer->remove(0, requestLength);
+                        socket->write(response);
+                    }
+                });
+                QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            }
+        });
+
+        m_ready.release();
+        exec();
+    }
+
+private:
+    QSemaphore m_ready;
+    quint16 m_port = 0;
+};
+
+// ---- driver --------------------------------------------------------------
+
+// Issues one request at a time and counts allocations between the first
+// measured request and the event-loop turn after the last one completes.
+// Each path gets a warm-up first (connections, lazy statics, caches).
+#ifdef BENCH_BASELINE_COMMIT
+constexpr const char* kVariant = "baseline " BENCH_BASELINE_COMMIT;
+#else
+constexpr const char* kVariant = "current";
+#endif
+
+class Runner
+{
+public:
+    using Issue = std::function<void(Runner* runner)>;
+
+    explicit Runner(int requests) : m_requests(requests) {}
+
+    void add(const char* name, Issue issue)
+    {
+        m_paths.append(Path{ name, std::move(issue), {} });
+    }
+
+    void start()
+    {
+        std::printf("allocationBench %s: %d requests per path, loopback HTTP\n", kVariant, m_requests);
+        schedule();
+    }
+
+    // Called from the request's callback
+    void done()
+    {
+        Untracked untracked;
+        schedule();
+    }
+
+private:
+    struct Path {
+        const char* name;
+        Issue issue;
+        Counts measured;
+    };
+
+    void schedule()
+    {
+        Untracked untracked;
+        QTimer::singleShot(0, qApp, [this]() { step(); });
+    }
+
+    void step()
+    {
+        {
+            Untracked untracked;
+            if (m_remaining == 0) {
+                if (m_phase == Phase::Measure) {
+                    const Counts end = Counts::now();
+                    m_paths[m_path].measured = { end.allocations - m_start.allocations,
+                                                 end.reallocations - m_start.reallocations,
+                                                 end.bytes - m_start.bytes };
+                    ++m_path;
+                    m_phase = Phase::Idle;
+                }
+                if (m_path == m_paths.size()) {
+                    report();
+                    QCoreApplication::quit();
+                    return;
+                }
+
+                if (m_phase == Phase::Idle) {
+                    m_phase = Phase::WarmUp;
+                    m_remaining = qMin(m_requests, 100);
+                } else {
+                    m_phase = Phase::Measure;
+                    m_remaining = m_requests;
+                    m_start = Counts::now();
+                }
+            }
+            --m_remaining;
+        }
+        m_paths[m_path].issue(this);
+    }
+
+    void report() const
+    {
+        std::printf("%-18s %12s %12s %12s\n", "path", "allocs/req", "reallocs/req", "bytes/req");
+        for (const Path& path : m_paths) {
+            std::printf("%-18s %12.1f %12.1f %12.0f\n", path.name,
+                        double(path.measured.allocations) / m_requests,
+                        double(path.measured.reallocations) / m_requests,
+                        double(path.measured.bytes) / m_requests);
+        }
+    }
+
+    QList<Path> m_paths;
+    qsizetype m_path = 0;
+    int m_requests;
+    int m_remaining = 0;
+    enum class Phase { Idle, WarmUp, Measure } m_phase = Phase::Idle;
+    Counts m_start;
+};
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Whatever request logging a side does is counted, only the output is dropped
+    qInstallMessageHandler([](QtMsgType, const QMessageLogContext&, const QString&) {});
+    QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+
+    const int requests = argc > 1 ? qMax(1, atoi(argv[1])) : 2000;
+
+    BenchServer server;
+    const quint16 port = server.start();
+
+    HttpClient client(QUrl(QStringLiteral("http://127.0.0.1:%1/").arg(port)));
+    ObjectApi objectApi(&client);
+    const QByteArray body = QJsonDocument(QJsonObject{ { "name", "bench" } }).toJson(QJsonDocument::Compact);
+    const QString id = "7";
+
+    Runner runner(requests);
+    runner.add("HttpClient::get", [&](Runner* r) {
+        client.get("objects/7", [r](QRestReply&) { r->done(); });
+    });
+    runner.add("HttpClient::post", [&](Runner* r) {
+        client.post("objects", body, [r](QRestReply&) { r->done(); });
+    });
+    // Callbacks capture like main.cpp does (a pointer and a QString)
+    runner.add("ObjectApi::get", [&](Runner* r) {
+        objectApi.get(id, [r, id](const QVariantMap&) { r->done(); },
+                      [r, id](const ErrorResult&) { r->done(); });
+    });
+
+    QTimer::singleShot(0, &app, [&runner]() { runner.start(); });
+    const int status = app.exec();
+
+    server.quit();
+    server.wait();
+    return status;
+}
@@ -3,7 +3,8 @@
 #include <QNetworkReply>
 #include <QPointer>
 #include <QString>
-#include <functional>
+
+#include "Callback.h"
 
 struct ErrorResult {
     int status = 0;
@@ -11,4 +12,4 @@ struct ErrorResult {
     QPointer<QNetworkReply> reply;
 };
 
-using ErrorCb = std::function<void(const ErrorResult&)>;
+using ErrorCb = Callback<void(const ErrorResult&)>;
@@ -0,0 +1,92 @@
+#include "BufferedReply.h"
+
+#include <cstring>
+
+BufferedReply::BufferedReply(QObject* parent)
+    : QNetworkReply(parent)
+{
+    open(QIODevice::ReadOnly);
+}
+
+void BufferedReply::copyMetaData(const QNetworkReply* from)
+{
+    if (!from) return;
+
+    setUrl(from->url());
+    setRequest(from->request());
+    setOperation(from->operation());
+    setHeaders(from->headers());
+
+    for (const auto attribute : {
+             QNetworkRequest::HttpStatusCodeAttribute,
+             QNetworkRequest::HttpReasonPhraseAttribute,
+             QNetworkRequest::RedirectionTargetAttribute,
+             QNetworkRequest::Http2WasUsedAttribute,
+             QNetworkRequest::OriginalContentLengthAttribute }) {
+        setAttribute(attribute, from->attribute(attribute));
+    }
+
+    if (from->error() != QNetworkReply::NoError)
+        setError(from->error(), from->errorString());
+}
+
+void BufferedReply::setRequestInfo(QNetworkAccessManager::Operation op, const QNetworkRequest& request)
+{
+    setOperation(op);
+    setRequest(request);
+    setUrl(request.url());
+}
+
+void BufferedReply::setContent(const QByteArray& content)
+{
+    m_content = content;
+    m_offset = 0;
+
+    QHttpHeaders h = headers();
+    h.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentLength, QByteArray::number(m_content.size()));
+    setHeaders(h);
+}
+
+void BufferedReply::setHttpStatus(int status, const QByteArray& reason)
+{
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, status);
+    setAttribute(QNetworkRequest::HttpReasonPhraseAttribute, reason);
+}
+
+void BufferedReply::complete()
+{
+    if (isFinished()) return;
+
+    setFinished(true);
+    emit metaDataChanged();
+    if (bytesAvailable() > 0)
+        emit readyRead();
+    if (error() != QNetworkReply::NoError)
+        emit errorOccurred(error());
+    emit finished();
+}
+
+void BufferedReply::abort()
+{
+    if (isFinished()) return;
+
+    m_content.clear();
+    m_offset = 0;
+    setError(QNetworkReply::OperationCanceledError, tr("Operation canceled"));
+    complete();
+}
+
+qint64 BufferedReply::bytesAvailable() const
+{
+    return (m_content.size() - m_offset) + QNetworkReply::bytesAvailable();
+}
+
+qint64 BufferedReply::readData(char* data, qint64 maxSize)
+{
+    const qint64 n = qMin(maxSize, qint64(m_content.size()) - m_offset);
+    if (n <= 0) return isFinished() ? -1 : 0;
+
+    std::memcpy(data, m_content.constData() + m_offset, size_t(n));
+    m_offset += n;
+    return n;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHttpHeaders>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+// In-memory QNetworkReply. Used to hand callbacks a body HttpClient has
+// already decoded, and as the base for replies not backed by a socket.
+class BufferedReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    explicit BufferedReply(QObject* parent = nullptr);
+
+    // Copies url, request, headers, HTTP attributes and error state
+    void copyMetaData(const QNetworkReply* from);
+
+    void setRequestInfo(QNetworkAccessManager::Operation op, const QNetworkRequest& request);
+    void setContent(const QByteArray& content);
+    void setHttpStatus(int status, const QByteArray& reason = {});
+    void setReplyHeaders(const QHttpHeaders& headers) { setHeaders(headers); }
+    void setReplyError(NetworkError code, const QString& message) { setError(code, message); }
+
+    // Marks the reply finished and emits metaDataChanged/readyRead/finished,
+    // no-op when already finished
+    void complete();
+
+    void abort() override;
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+
+private:
+    QByteArray m_content;
+    qint64 m_offset = 0;
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Move-only stand-in for std::function. Callables up to kInlineSize bytes
+// (a lambda capturing a few pointers or a QString) are stored in place
+// instead of on the heap, and the callback is never copied.
+template<typename Signature>
+class Callback;
+
+template<typename R, typename... Args>
+class Callback<R(Args...)>
+{
+public:
+    static constexpr std::size_t kInlineSize = 4 * sizeof(void*);
+
+    Callback() noexcept = default;
+    Callback(std::nullptr_t) noexcept {}
+
+    template<typename F>
+    requires (!std::is_same_v<std::remove_cvref_t<F>, Callback>
+              && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+    Callback(F&& f)
+    {
+        using Fn = std::decay_t<F>;
+
+        // Empty std::function / null function pointer -> empty callback
+        if constexpr (std::is_constructible_v<bool, const Fn&>) {
+            if (!static_cast<bool>(f)) return;
+        }
+
+        if constexpr (fitsInline<Fn>) {
+            ::new (static_cast<void*>(m_storage)) Fn(std::forward<F>(f));
+            m_ops = &inlineOps<Fn>;
+        } else {
+            *reinterpret_cast<Fn**>(m_storage) = new Fn(std::forward<F>(f));
+            m_ops = &heapOps<Fn>;
+        }
+    }
+
+    Callback(Callback&& other) noexcept { moveFrom(other); }
+
+    Callback& operator=(Callback&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    Callback& operator=(std::nullptr_t) noexcept
+    {
+        reset();
+        return *this;
+    }
+
+    Callback(const Callback&) = delete;
+    Callback& operator=(const Callback&) = delete;
+
+    ~Callback() { reset(); }
+
+    explicit operator bool() const noexcept { return m_ops != nullptr; }
+
+    R operator()(Args... args) const
+    {
+        return m_ops->invoke(const_cast<unsigned char*>(m_storage), std::forward<Args>(args)...);
+    }
+
+private:
+    struct Ops {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* dst, void* src) noexcept; // leaves src destroyed
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template<typename Fn>
+    static constexpr bool fitsInline = sizeof(Fn) <= kInlineSize
+        && alignof(Fn) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<Fn>;
+
+    template<typename Fn>
+    static constexpr Ops inlineOps = {
+        [](void* s, Args&&... args) -> R {
+            return std::invoke(*static_cast<Fn*>(s), std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) Fn(std::move(*static_cast<Fn*>(src)));
+            static_cast<Fn*>(src)->~Fn();
+        },
+        [](void* s) noexcept { static_cast<Fn*>(s)->~Fn(); }
+    };
+
+    template<typename Fn>
+    static constexpr Ops heapOps = {
+        [](void* s, Args&&... args) -> R {
+            return std::invoke(**static_cast<Fn**>(s), std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) noexcept { *static_cast<Fn**>(dst) = *static_cast<Fn**>(src); },
+        [](void* s) noexcept { delete *static_cast<Fn**>(s); }
+    };
+
+    void moveFrom(Callback& other) noexcept
+    {
+        if (!other.m_ops) return;
+        other.m_ops->move(m_storage, other.m_storage);
+        m_ops = std::exchange(other.m_ops, nullptr);
+    }
+
+    void reset() noexcept
+    {
+        if (!m_ops) return;
+        std::exchange(m_ops, nullptr)->destroy(m_storage);
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char m_storage[kInlineSize];
+    const Ops* m_ops = nullptr;
+};
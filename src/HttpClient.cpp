@@ -0,0 +1,409 @@
+#include "HttpClient.h"
+
+#include <QHttpHeaders>
+#include <QMetaMethod>
+#include <QUrlQuery>
+#include <QtGlobal>
+#include <cmath>
+#include <ctime>
+#include <utility>
+
+#ifdef Q_OS_WIN
+#include <qt_windows.h>
+#endif
+
+#include "BufferedReply.h"
+
+Q_LOGGING_CATEGORY(lcHttpClient, "networking.http", QtInfoMsg)
+
+namespace {
+
+// CPU time consumed by the calling thread, in ns
+qint64 threadCpuNs()
+{
+#if defined(Q_OS_WIN)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return 0;
+    const auto ticks = [](const FILETIME& t) { return (qint64(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+    return (ticks(kernel) + ticks(user)) * 100; // 100 ns units
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+        return 0;
+    return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    // Process-wide, but still CPU time
+    return qint64(std::clock()) * (1000000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+QByteArray methodName(const QNetworkReply* reply)
+{
+    switch (reply->operation()) {
+    case QNetworkAccessManager::HeadOperation:   return QByteArrayLiteral("HEAD");
+    case QNetworkAccessManager::GetOperation:    return QByteArrayLiteral("GET");
+    case QNetworkAccessManager::PutOperation:    return QByteArrayLiteral("PUT");
+    case QNetworkAccessManager::PostOperation:   return QByteArrayLiteral("POST");
+    case QNetworkAccessManager::DeleteOperation: return QByteArrayLiteral("DELETE");
+    case QNetworkAccessManager::CustomOperation:
+        return reply->request().attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+    default:
+        return {};
+    }
+}
+
+} // namespace
+
+void RequestHandle::abort()
+{
+    if (m_aborted || m_done) return;
+    m_aborted = true;
+
+    // Cancel the transfer too, not just the callback
+    if (QNetworkReply* reply = std::exchange(m_reply, nullptr))
+        reply->abort();
+
+    if (auto* client = qobject_cast<HttpClient*>(parent()))
+        client->finishHandle(this);
+    else
+        deleteLater();
+}
+
+HttpClient::HttpClient(const QUrl& baseUrl, QObject *parent)
+    : HttpClient(nullptr, baseUrl, parent)
+{
+}
+
+HttpClient::HttpClient(QNetworkAccessManager* manager, const QUrl& baseUrl, QObject *parent)
+    : QObject(parent)
+    , m_rest(manager ? manager : &m_nam)
+    , m_factory(baseUrl)
+{
+    // Common headers
+    QHttpHeaders headers;
+    headers.append(QHttpHeaders::WellKnownHeader::Accept, "application/json");
+    headers.append(QHttpHeaders::WellKnownHeader::ContentType, "application/json");
+    m_factory.setCommonHeaders(headers);
+
+    // Timeout
+    m_factory.setTransferTimeout(std::chrono::seconds(15));
+}
+
+void HttpClient::setBaseUrl(const QUrl& baseUrl)
+{
+    m_factory.setBaseUrl(baseUrl);
+    m_requestTemplate.reset();
+}
+
+void HttpClient::setBearerToken(const QByteArray& token)
+{
+    m_factory.setBearerToken(token);
+    m_requestTemplate.reset();
+}
+
+void HttpClient::clearBearerToken()
+{
+    m_factory.setBearerToken(QByteArray{});
+    m_requestTemplate.reset();
+}
+
+void HttpClient::setCommonHeaders(const QHttpHeaders& headers)
+{
+    m_factory.setCommonHeaders(headers);
+    m_requestTemplate.reset();
+}
+
+void HttpClient::setTransferTimeout(std::chrono::milliseconds timeout)
+{
+    m_factory.setTransferTimeout(timeout);
+    m_requestTemplate.reset();
+}
+
+void HttpClient::setCompression(const CompressionOptions& options)
+{
+    m_compression = options;
+    m_requestTemplate.reset(); // Accept-Encoding is part of the template
+}
+
+QNetworkRequest HttpClient::buildRequest(const QString& urlOrPath) const
+{
+    if (!m_requestTemplate) {
+        QNetworkRequest req = m_factory.createRequest();
+
+        // Setting Accept-Encoding turns off Qt's transparent decompression,
+        // the body is decoded in attachDecoder/finishDecoding instead
+        if (!m_compression.acceptEncodings.isEmpty()) {
+            const QByteArray accept = HttpCompression::acceptEncodingHeader(m_compression.acceptEncodings);
+            if (!accept.isEmpty())
+                req.setRawHeader("Accept-Encoding", accept);
+        }
+
+        m_requestTemplate = req;
+    }
+
+    // QNetworkRequest is implicitly shared: copying the template is a
+    // refcount bump, only setUrl detaches
+    QNetworkRequest req = *m_requestTemplate;
+    req.setUrl(resolveUrl(urlOrPath)); // invalid url -> caller handles
+    return req;
+}
+
+QUrl HttpClient::resolveUrl(const QString& urlOrPath) const
+{
+    const QUrl url(urlOrPath);
+    if (!url.isValid())
+        return {};
+
+    // Absolute URL -> used as-is (template keeps headers, bearer, timeout)
+    if (!url.isRelative())
+        return url;
+
+    // Host without scheme ("//host/x") is not a path; same as the factory
+    if (!url.host().isEmpty())
+        return {};
+
+    // Relative path -> baseUrl + path [+ query], joined the way
+    // QNetworkRequestFactory does: exactly one slash between the two
+    QUrl result = m_factory.baseUrl();
+    QString basePath = result.path(QUrl::FullyEncoded);
+    const QString path = url.path(QUrl::FullyEncoded);
+    if (!path.isEmpty()) {
+        if (!basePath.endsWith('/') && !path.startsWith('/'))
+            basePath.append('/');
+        else if (basePath.endsWith('/') && path.startsWith('/'))
+            basePath.chop(1);
+    }
+    basePath.append(path);
+    result.setPath(basePath, QUrl::StrictMode);
+
+    QUrlQuery query(url);
+    const QUrlQuery common = m_factory.queryParameters();
+    for (const auto& [key, value] : common.queryItems(QUrl::FullyEncoded))
+        query.addQueryItem(key, value);
+    result.setQuery(query);
+
+    return result;
+}
+
+QByteArray HttpClient::encodeBody(QNetworkRequest& req, const QByteArray& data, RequestHandle* handle) const
+{
+    RequestMetrics& metrics = handle->m_metrics;
+    metrics.requestBytes = data.size();
+    metrics.requestWireBytes = data.size();
+
+    const ContentEncoding encoding = m_compression.requestEncoding;
+    if (encoding == ContentEncoding::Identity || data.size() < m_compression.minRequestBytes)
+        return data;
+
+    const qint64 cpuStart = threadCpuNs();
+    const std::optional<QByteArray> compressed = HttpCompression::compress(encoding, data, m_compression.level);
+    metrics.compressCpuNs = threadCpuNs() - cpuStart;
+
+    // Not worth it (or codec unavailable): send as-is
+    if (!compressed || compressed->size() >= data.size())
+        return data;
+
+    const QByteArray token = HttpCompression::token(encoding);
+    req.setRawHeader("Content-Encoding", token);
+    metrics.requestEncoding = token;
+    metrics.requestWireBytes = compressed->size();
+    return *compressed;
+}
+
+void HttpClient::observeReply(RequestHandle* handle, QNetworkReply* reply, const QByteArray& requestBody) const
+{
+    handle->m_reply = reply;
+    attachDecoder(handle, reply);
+    handle->m_recordId = m_recorder ? m_recorder->begin(reply, requestBody) : -1;
+}
+
+std::optional<QRestReply> HttpClient::completeAttempt(RequestHandle* handle, QRestReply& rawReply) const
+{
+    // The reply is deleted once this callback returns
+    handle->m_reply = nullptr;
+
+    std::optional<QRestReply> decoded = finishDecoding(handle, rawReply);
+    recordReply(handle, decoded ? *decoded : rawReply);
+    return decoded;
+}
+
+void HttpClient::recordReply(RequestHandle* handle, QRestReply& reply) const
+{
+    if (!m_recorder || handle->m_recordId < 0) return;
+    m_recorder->finish(std::exchange(handle->m_recordId, -1), reply.networkReply());
+}
+
+void HttpClient::attachDecoder(RequestHandle* handle, QNetworkReply* reply) const
+{
+    // Reset per attempt (retries reuse the handle)
+    handle->m_decoder.reset();
+    handle->m_decodeResolved = false;
+    handle->m_decodeFailed = false;
+    handle->m_metrics.responseEncoding.clear();
+    handle->m_metrics.responseWireBytes = 0;
+    handle->m_metrics.responseBytes = 0;
+    handle->m_metrics.decompressCpuNs = 0;
+
+    // Decided per attempt from what was sent; setCompression() while the
+    // reply is in flight must not change how its body is handled
+    handle->m_decodes = reply
+        && !m_compression.acceptEncodings.isEmpty()
+        && reply->request().hasRawHeader("Accept-Encoding");
+    if (!handle->m_decodes)
+        return;
+
+    // Inflate chunk by chunk as the body arrives instead of after the fact
+    QObject::connect(reply, &QNetworkReply::readyRead, handle, [handle, reply]() {
+        if (!isLive(handle)) return;
+        feedDecoder(handle, reply);
+    });
+}
+
+void HttpClient::feedDecoder(RequestHandle* handle, QNetworkReply* reply)
+{
+    if (!handle->m_decodeResolved) {
+        handle->m_decodeResolved = true;
+
+        const QByteArray header = reply->headers().combinedValue(QHttpHeaders::WellKnownHeader::ContentEncoding);
+        const std::optional<ContentEncoding> encoding = HttpCompression::fromToken(header);
+
+        // Identity bodies are left in the reply untouched
+        if (encoding && *encoding == ContentEncoding::Identity)
+            return;
+
+        handle->m_metrics.responseEncoding = header;
+        if (encoding)
+            handle->m_decoder = StreamDecoder::create(*encoding);
+        if (!handle->m_decoder)
+            handle->m_decodeFailed = true;
+    }
+
+    if (!handle->m_decoder || handle->m_decodeFailed)
+        return;
+
+    const QByteArray chunk = reply->readAll();
+    if (chunk.isEmpty())
+        return;
+
+    RequestMetrics& metrics = handle->m_metrics;
+    QByteArray decoded;
+
+    const qint64 cpuStart = threadCpuNs();
+    const bool ok = handle->m_decoder->feed(chunk, decoded);
+    metrics.decompressCpuNs += threadCpuNs() - cpuStart;
+
+    metrics.responseWireBytes += chunk.size();
+    metrics.responseBytes += decoded.size();
+    handle->m_decoded += decoded;
+
+    if (!ok)
+        handle->m_decodeFailed = true;
+}
+
+std::optional<QRestReply> HttpClient::finishDecoding(RequestHandle* handle, QRestReply& reply) const
+{
+    QNetworkReply* networkReply = reply.networkReply();
+    if (!networkReply || !handle->m_decodes)
+        return std::nullopt;
+
+    // Drain whatever arrived after the last readyRead
+    feedDecoder(handle, networkReply);
+
+    if (!handle->m_decoder && !handle->m_decodeFailed)
+        return std::nullopt;
+
+    // Same lifetime as the wrapped reply, which Qt deletes after the callback
+    auto* decoded = new BufferedReply();
+    decoded->deleteLater();
+    decoded->copyMetaData(networkReply);
+
+    QHttpHeaders headers = decoded->headers();
+    headers.removeAll(QHttpHeaders::WellKnownHeader::ContentEncoding);
+    decoded->setReplyHeaders(headers);
+
+    const bool ok = !handle->m_decodeFailed && handle->m_decoder->finish();
+    if (ok) {
+        decoded->setContent(std::exchange(handle->m_decoded, {}));
+    } else {
+        handle->m_decoded.clear();
+        if (networkReply->error() == QNetworkReply::NoError)
+            decoded->setReplyError(QNetworkReply::ProtocolFailure, "Failed to decode response body");
+    }
+
+    decoded->complete();
+    handle->m_decoder.reset();
+    return std::optional<QRestReply>(std::in_place, decoded);
+}
+
+void HttpClient::reportCompleted(RequestHandle* handle, const QRestReply& reply)
+{
+    // Cheap enough to always fill (literal method, shared url), so
+    // RequestHandle::metrics() stays complete without a listener
+    RequestMetrics& metrics = handle->m_metrics;
+    if (const QNetworkReply* networkReply = reply.networkReply()) {
+        metrics.method = methodName(networkReply);
+        metrics.url = networkReply->url();
+    }
+    metrics.httpStatus = reply.httpStatus();
+
+    static const QMetaMethod completedSignal = QMetaMethod::fromSignal(&HttpClient::requestCompleted);
+    if (isSignalConnected(completedSignal))
+        emit requestCompleted(metrics);
+}
+
+int HttpClient::retryDelayMs(const RetryPolicy& policy, int attemptNo)
+{
+    const int expIndex = qMax(0, attemptNo - 1);
+    const double raw = policy.baseDelayMs * std::pow(policy.multiplier, expIndex); // baseDelayMs * (multiplier) ^ exponent
+    const int ms = static_cast<int>(raw);
+    return qBound(0, ms, policy.maxDelayMs);
+}
+
+const SharedRetryPolicy& HttpClient::noRetryPolicy()
+{
+    static const SharedRetryPolicy policy = std::make_shared<const RetryPolicy>();
+    return policy;
+}
+
+void HttpClient::finishHandle(RequestHandle* handle)
+{
+    if (handle->m_done) return;
+    handle->m_done = true;
+    handle->m_reply = nullptr;
+
+    if (m_recorder && handle->m_recordId >= 0)
+        m_recorder->finish(std::exchange(handle->m_recordId, -1), nullptr); // drop the pending entry
+
+    // Called directly instead of via finished/failed connections,
+    // saving two connections per request
+    handle->deleteLater();
+}
+
+void HttpClient::failInvalidUrl(RequestHandle* handle)
+{
+    handle->m_done = true;
+
+    // Queued so callers get to connect to the handle they were just given
+    QMetaObject::invokeMethod(handle, [handle]() {
+        emit handle->failed("Invalid URL", 0);
+        handle->deleteLater();
+    }, Qt::QueuedConnection);
+}
+
+bool HttpClient::shouldRetry(const QRestReply& reply, const RetryPolicy& policy, int attemptNo) const
+{
+    if (attemptNo >= policy.maxAttempts)
+        return false;
+
+    if (policy.shouldRetry)
+        return policy.shouldRetry(reply);
+
+    const int status = reply.httpStatus();
+
+    // Network/transport error (no valid HTTP status)
+    if (status <= 0)
+        return policy.retryOnNetworkError;
+
+    return policy.retryHttpStatus.contains(status);
+}
@@ -0,0 +1,409 @@
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QNetworkRequestFactory>
+#include <QRestAccessManager>
+#include <QRestReply>
+#include <QTimer>
+#include <QUrl>
+#include <QDebug>
+#include <QLoggingCategory>
+#include <QHttpHeaders>
+#include <chrono>
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <optional>
+
+#include "HttpCompression.h"
+#include "TrafficRecorder.h"
+
+// One debug line per request attempt; off by default, turn on with
+// QT_LOGGING_RULES="networking.http.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcHttpClient)
+
+struct RetryPolicy {
+    int maxAttempts = 1; // 1 = no retry
+    int baseDelayMs = 200;
+    double multiplier = 2.0;
+    int maxDelayMs = 5000;
+
+    bool retryOnNetworkError = true; // e.g. httpStatus <= 0
+    QList<int> retryHttpStatus = { 408, 429, 500, 502, 503, 504 };
+
+    std::function<bool(const QRestReply&)> shouldRetry = {}; // optional override
+};
+
+// Policies are immutable once handed to HttpClient; build one per route
+// and reuse it instead of passing a fresh RetryPolicy per call
+using SharedRetryPolicy = std::shared_ptr<const RetryPolicy>;
+
+// Codec times are CPU time of the calling thread (CLOCK_THREAD_CPUTIME_ID,
+// GetThreadTimes on Windows), not wall time
+struct RequestMetrics {
+    QByteArray method;
+    QUrl url;
+    int httpStatus = 0;
+
+    // Request body
+    QByteArray requestEncoding; // Content-Encoding sent, empty = identity
+    qint64 requestBytes = 0;     // before compression
+    qint64 requestWireBytes = 0; // as sent
+    qint64 compressCpuNs = 0;
+
+    // Response body (only tracked when HttpClient decodes it itself)
+    QByteArray responseEncoding;
+    qint64 responseWireBytes = 0;
+    qint64 responseBytes = 0;
+    qint64 decompressCpuNs = 0;
+
+    double requestRatio() const { return requestWireBytes ? double(requestBytes) / requestWireBytes : 1.0; }
+    double responseRatio() const { return responseWireBytes ? double(responseBytes) / responseWireBytes : 1.0; }
+};
+
+class HttpClient;
+
+// Deleted (deleteLater) once finished/failed has been emitted or after
+// abort(); keep it in a QPointer when it may outlive the request.
+class RequestHandle : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RequestHandle(QObject* parent = nullptr) : QObject(parent) {}
+
+    Q_INVOKABLE void abort();
+
+    bool aborted() const { return m_aborted; }
+
+    // Also delivered by HttpClient::requestCompleted
+    const RequestMetrics& metrics() const { return m_metrics; }
+
+signals:
+    void attempt(int n);
+    void finished(QRestReply &reply);
+    void failed(QString message, int httpStatus);
+
+private:
+    friend class HttpClient;
+
+    bool m_aborted = false;
+    bool m_done = false;              // finished/failed delivered, deletion pending
+    QNetworkReply* m_reply = nullptr; // in-flight attempt, cleared when its callback runs
+    RequestMetrics m_metrics;
+
+    std::unique_ptr<StreamDecoder> m_decoder;
+    QByteArray m_decoded;
+    bool m_decodeResolved = false; // Content-Encoding of the response inspected
+    bool m_decodeFailed = false;
+    bool m_decodes = false; // this attempt sent our own Accept-Encoding, so HttpClient decodes
+
+    int m_recordId = -1; // TrafficRecorder entry of the current attempt
+};
+
+class HttpClient : public QObject
+{
+    Q_OBJECT
+
+public:
+signals:
+    void networkError(QString message, int httpStatus);
+
+    // Emitted once per finished (not aborted) request, before the handle's
+    // own signals; the way to get metrics for calls made through the APIs
+    void requestCompleted(const RequestMetrics& metrics);
+
+public:
+    explicit HttpClient(const QUrl& baseUrl = {}, QObject *parent = nullptr);
+
+    // Sends through `manager` instead of the built-in one, e.g. a
+    // ReplayNetworkAccessManager. The manager must outlive the client.
+    explicit HttpClient(QNetworkAccessManager* manager, const QUrl& baseUrl = {}, QObject *parent = nullptr);
+
+    void setBaseUrl(const QUrl& baseUrl);
+    void setBearerToken(const QByteArray& token);
+    void clearBearerToken();
+    void setCommonHeaders(const QHttpHeaders& headers);
+    void setTransferTimeout(std::chrono::milliseconds timeout);
+
+    void setCompression(const CompressionOptions& options);
+    const CompressionOptions& compression() const { return m_compression; }
+
+    // Request/response pairs are captured while the recorder is started
+    void setRecorder(TrafficRecorder* recorder) { m_recorder = recorder; }
+    TrafficRecorder* recorder() const { return m_recorder; }
+
+    QRestAccessManager& rest() { return m_rest; }
+
+    // Read-only: requests are built from a cached template, so changes
+    // go through the setters above or updateFactory(), which refresh it
+    const QNetworkRequestFactory& factory() const { return m_factory; }
+
+    // For factory settings without a setter here (query parameters,
+    // attributes, priority...):
+    //   client.updateFactory([&](QNetworkRequestFactory& f) { f.setQueryParameters(query); });
+    template<typename Fn>
+    requires std::invocable<Fn, QNetworkRequestFactory&>
+    void updateFactory(Fn&& fn)
+    {
+        std::forward<Fn>(fn)(m_factory);
+        m_requestTemplate.reset();
+    }
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply &>
+    RequestHandle* get(const QString& urlOrPath, Functor&& callback)
+    {
+        // Since Qt's MOC doesn't like having a default parameter with a
+        // RetryPolicy initialization, we use function overloading instead
+        // I.e. Qt complains on `RetryPolicy policy = {}` as default parameter
+        return get(urlOrPath, std::forward<Functor>(callback), noRetryPolicy());
+    }
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply &>
+    RequestHandle* get(const QString& urlOrPath, Functor&& callback, RetryPolicy policy)
+    {
+        return get(urlOrPath, std::forward<Functor>(callback),
+                   std::make_shared<const RetryPolicy>(std::move(policy)));
+    }
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply &>
+    RequestHandle* get(const QString& urlOrPath, Functor&& callback, SharedRetryPolicy policy)
+    {
+        auto* handle = new RequestHandle(this);
+
+        // One allocation shared by every attempt, instead of copying the
+        // callback and policy into each retry
+        auto state = std::make_shared<GetState<std::decay_t<Functor>>>(
+            urlOrPath,
+            policy ? std::move(policy) : noRetryPolicy(),
+            std::forward<Functor>(callback));
+
+        getAttempt(handle, std::move(state), 1);
+        return handle;
+    }
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply&>
+    RequestHandle* post(const QString& urlOrPath, const QByteArray& data, Functor&& callback)
+    {
+        auto* handle = new RequestHandle(this);
+        emit handle->attempt(1);
+
+        QNetworkRequest req = buildRequest(urlOrPath);
+        if (!req.url().isValid()) {
+            failInvalidUrl(handle);
+            return handle;
+        }
+
+        const QByteArray body = encodeBody(req, data, handle);
+
+        qCDebug(lcHttpClient).noquote() << "[NETWORK] POST:" << req.url().toString();
+
+        QNetworkReply* networkReply = m_rest.post(req, body, handle, makeReplyHandler(handle, std::forward<Functor>(callback)));
+        observeReply(handle, networkReply, body);
+        return handle;
+    }
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply&>
+    RequestHandle* put(const QString& urlOrPath, const QByteArray& data, Functor&& callback)
+    {
+        auto* handle = new RequestHandle(this);
+        emit handle->attempt(1);
+
+        QNetworkRequest req = buildRequest(urlOrPath);
+        if (!req.url().isValid()) {
+            failInvalidUrl(handle);
+            return handle;
+        }
+
+        const QByteArray body = encodeBody(req, data, handle);
+
+        qCDebug(lcHttpClient).noquote() << "[NETWORK] PUT:" << req.url().toString();
+
+        QNetworkReply* networkReply = m_rest.put(req, body, handle, makeReplyHandler(handle, std::forward<Functor>(callback)));
+        observeReply(handle, networkReply, body);
+        return handle;
+    }
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply&>
+    RequestHandle* patch(const QString& urlOrPath, const QByteArray& data, Functor&& callback)
+    {
+        auto* handle = new RequestHandle(this);
+        emit handle->attempt(1);
+
+        QNetworkRequest req = buildRequest(urlOrPath);
+        if (!req.url().isValid()) {
+            failInvalidUrl(handle);
+            return handle;
+        }
+
+        const QByteArray body = encodeBody(req, data, handle);
+
+        qCDebug(lcHttpClient).noquote() << "[NETWORK] PATCH:" << req.url().toString();
+
+        QNetworkReply* networkReply = m_rest.patch(req, body, handle, makeReplyHandler(handle, std::forward<Functor>(callback)));
+        observeReply(handle, networkReply, body);
+        return handle;
+    }
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply&>
+    RequestHandle* remove(const QString& urlOrPath, Functor&& callback)
+    {
+        auto* handle = new RequestHandle(this);
+        emit handle->attempt(1);
+
+        const QNetworkRequest req = buildRequest(urlOrPath);
+        if (!req.url().isValid()) {
+            failInvalidUrl(handle);
+            return handle;
+        }
+
+        qCDebug(lcHttpClient).noquote() << "[NETWORK] DELETE:" << req.url().toString();
+
+        QNetworkReply* networkReply = m_rest.deleteResource(req, handle, makeReplyHandler(handle, std::forward<Functor>(callback)));
+        observeReply(handle, networkReply);
+        return handle;
+    }
+
+private:
+    friend class RequestHandle;
+
+    template<typename Functor>
+    struct GetState {
+        GetState(const QString& urlOrPath, SharedRetryPolicy policy, Functor&& cb)
+            : urlOrPath(urlOrPath), policy(std::move(policy)), cb(std::move(cb)) {}
+        GetState(const QString& urlOrPath, SharedRetryPolicy policy, const Functor& cb)
+            : urlOrPath(urlOrPath), policy(std::move(policy)), cb(cb) {}
+
+        const QString urlOrPath;
+        const SharedRetryPolicy policy;
+        Functor cb;
+    };
+
+    template<typename Functor>
+    void getAttempt(RequestHandle* handle, std::shared_ptr<GetState<Functor>> state, int attemptNo)
+    {
+        if (!isLive(handle)) return;
+        emit handle->attempt(attemptNo);
+
+        const QNetworkRequest req = buildRequest(state->urlOrPath);
+        const QUrl url = req.url();
+        if (!url.isValid()) {
+            failInvalidUrl(handle);
+            return;
+        }
+
+        qCDebug(lcHttpClient).noquote() << QStringLiteral("[NETWORK] Fetch (%1):").arg(attemptNo) << req.url().toString();
+
+        QNetworkReply* networkReply = m_rest.get(req, handle, [this, handle, state, attemptNo](QRestReply &rawReply) {
+            if (!isLive(handle)) return;
+
+            std::optional<QRestReply> decoded = completeAttempt(handle, rawReply);
+            QRestReply& reply = decoded ? *decoded : rawReply;
+
+            if (reply.isSuccess()) {
+                reportCompleted(handle, reply);
+                emit handle->finished(reply);
+                state->cb(reply);
+                finishHandle(handle);
+                return;
+            }
+
+            const bool willRetry = shouldRetry(reply, *state->policy, attemptNo);
+            if (!willRetry) {
+                reportCompleted(handle, reply);
+                emit networkError(reply.errorString(), reply.httpStatus());
+                emit handle->failed(reply.errorString(), reply.httpStatus());
+                state->cb(reply); // invoke callback on failure
+                finishHandle(handle);
+                return;
+            }
+
+            const int delay = retryDelayMs(*state->policy, attemptNo);
+            QTimer::singleShot(delay, handle, [this, handle, state, attemptNo]() {
+                getAttempt(handle, state, attemptNo + 1);
+            });
+        });
+        observeReply(handle, networkReply);
+    }
+
+    QNetworkRequest buildRequest(const QString& urlOrPath) const;
+    QUrl resolveUrl(const QString& urlOrPath) const;
+
+    // Compresses the body when configured and sets Content-Encoding on req
+    QByteArray encodeBody(QNetworkRequest& req, const QByteArray& data, RequestHandle* handle) const;
+
+    // Per-attempt hooks: response decoding and traffic recording.
+    // completeAttempt returns the decoded reply when HttpClient decoded the body.
+    void observeReply(RequestHandle* handle, QNetworkReply* reply, const QByteArray& requestBody = {}) const;
+    std::optional<QRestReply> completeAttempt(RequestHandle* handle, QRestReply& rawReply) const;
+    void recordReply(RequestHandle* handle, QRestReply& reply) const;
+
+    // Streams the response body through a decoder when HttpClient
+    // negotiated the encoding itself (CompressionOptions::acceptEncodings)
+    void attachDecoder(RequestHandle* handle, QNetworkReply* reply) const;
+    static void feedDecoder(RequestHandle* handle, QNetworkReply* reply);
+    std::optional<QRestReply> finishDecoding(RequestHandle* handle, QRestReply& reply) const;
+
+    // Fills the per-request part of the metrics and emits requestCompleted
+    void reportCompleted(RequestHandle* handle, const QRestReply& reply);
+
+    template<typename Functor>
+    requires std::invocable<Functor, QRestReply&>
+    auto makeReplyHandler(RequestHandle* handle, Functor&& callback)
+    {
+        return [this, handle, cb = std::forward<Functor>(callback)](QRestReply& rawReply) mutable {
+            if (!isLive(handle)) return;
+
+            std::optional<QRestReply> decoded = completeAttempt(handle, rawReply);
+            QRestReply& reply = decoded ? *decoded : rawReply;
+            reportCompleted(handle, reply);
+
+            if (reply.isSuccess()) {
+                emit handle->finished(reply);
+                cb(reply);
+                finishHandle(handle);
+                return;
+            }
+
+            emit networkError(reply.errorString(), reply.httpStatus());
+            emit handle->failed(reply.errorString(), reply.httpStatus());
+            cb(reply); // invoke callback on failure
+            finishHandle(handle);
+        };
+    }
+
+    static int retryDelayMs(const RetryPolicy& policy, int attemptNo);
+    static const SharedRetryPolicy& noRetryPolicy();
+
+    void finishHandle(RequestHandle* handle);
+    static void failInvalidUrl(RequestHandle* handle);
+    static bool isLive(const RequestHandle* handle)
+    {
+        return !handle->m_aborted && !handle->m_done;
+    }
+
+    bool shouldRetry(const QRestReply& reply, const RetryPolicy& policy, int attemptNo) const;
+
+private:
+    QNetworkAccessManager m_nam;
+    QRestAccessManager m_rest;
+    QNetworkRequestFactory m_factory;
+    CompressionOptions m_compression;
+    QPointer<TrafficRecorder> m_recorder;
+
+
+    // Factory output (headers, bearer, timeout) + Accept-Encoding; only the
+    // url differs between requests. Reset by every setter that affects it.
+    mutable std::optional<QNetworkRequest> m_requestTemplate;
+};
@@ -0,0 +1,269 @@
+#include "HttpCompression.h"
+
+#include <QtGlobal>
+
+#ifdef HTTPCLIENT_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HTTPCLIENT_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr int kChunkSize = 16 * 1024;
+
+#ifdef HTTPCLIENT_HAS_ZLIB
+// windowBits: 15 = zlib wrapper ("deflate" in HTTP), 15 + 16 = gzip,
+// 15 + 32 = auto-detect either when inflating
+constexpr int kZlibWindow = 15;
+constexpr int kGzipWindow = 15 + 16;
+constexpr int kAutoWindow = 15 + 32;
+
+std::optional<QByteArray> zlibCompress(QByteArrayView data, int windowBits, int level)
+{
+    z_stream zs{};
+    if (deflateInit2(&zs, level < 0 ? Z_DEFAULT_COMPRESSION : qBound(0, level, 9),
+                     Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return std::nullopt;
+
+    QByteArray out;
+    out.resize(qsizetype(deflateBound(&zs, uLong(data.size()))));
+
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = uInt(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = uInt(out.size());
+
+    const int rc = deflate(&zs, Z_FINISH);
+    out.resize(qsizetype(zs.total_out));
+    deflateEnd(&zs);
+
+    if (rc != Z_STREAM_END) return std::nullopt;
+    return out;
+}
+#endif
+
+class IdentityDecoder : public StreamDecoder
+{
+public:
+    bool feed(QByteArrayView chunk, QByteArray& out) override
+    {
+        out.append(chunk);
+        return true;
+    }
+
+    bool finish() override { return true; }
+};
+
+#ifdef HTTPCLIENT_HAS_ZLIB
+class ZlibDecoder : public StreamDecoder
+{
+public:
+    ZlibDecoder() { m_ok = inflateInit2(&m_zs, kAutoWindow) == Z_OK; }
+    ~ZlibDecoder() override { if (m_ok) inflateEnd(&m_zs); }
+
+    bool feed(QByteArrayView chunk, QByteArray& out) override
+    {
+        if (!m_ok) return false;
+        if (m_done) return chunk.isEmpty();
+        if (chunk.isEmpty()) return true;
+        m_fed = true;
+
+        m_zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.data()));
+        m_zs.avail_in = uInt(chunk.size());
+
+        char buffer[kChunkSize];
+        do {
+            m_zs.next_out = reinterpret_cast<Bytef*>(buffer);
+            m_zs.avail_out = sizeof(buffer);
+
+            const int rc = inflate(&m_zs, Z_NO_FLUSH);
+            if (rc != Z_OK && rc != Z_STREAM_END && rc != Z_BUF_ERROR) {
+                m_ok = false;
+                return false;
+            }
+
+            out.append(buffer, qsizetype(sizeof(buffer) - m_zs.avail_out));
+
+            if (rc == Z_STREAM_END) {
+                m_done = true;
+                break;
+            }
+        } while (m_zs.avail_out == 0);
+
+        return true;
+    }
+
+    // An empty body (HEAD, 204, 304) is valid even when labelled gzip
+    bool finish() override { return m_ok && (m_done || !m_fed); }
+
+private:
+    z_stream m_zs{};
+    bool m_ok = false;
+    bool m_fed = false;
+    bool m_done = false;
+};
+#endif
+
+#ifdef HTTPCLIENT_HAS_ZSTD
+class ZstdDecoder : public StreamDecoder
+{
+public:
+    ZstdDecoder() : m_stream(ZSTD_createDStream()) {}
+    ~ZstdDecoder() override { ZSTD_freeDStream(m_stream); }
+
+    bool feed(QByteArrayView chunk, QByteArray& out) override
+    {
+        if (!m_stream || m_failed) return false;
+
+        ZSTD_inBuffer in{ chunk.data(), size_t(chunk.size()), 0 };
+        char buffer[kChunkSize];
+
+        for (;;) {
+            ZSTD_outBuffer o{ buffer, sizeof(buffer), 0 };
+            const size_t rc = ZSTD_decompressStream(m_stream, &o, &in);
+            if (ZSTD_isError(rc)) {
+                m_failed = true;
+                return false;
+            }
+
+            out.append(buffer, qsizetype(o.pos));
+            m_pending = rc;
+
+            if (in.pos == in.size && o.pos < o.size) break;
+        }
+        return true;
+    }
+
+    bool finish() override { return m_stream && !m_failed && m_pending == 0; }
+
+private:
+    ZSTD_DStream* m_stream = nullptr;
+    size_t m_pending = 0; // 0 once a frame is fully decoded
+    bool m_failed = false;
+};
+#endif
+
+} // namespace
+
+namespace HttpCompression {
+
+QByteArray token(ContentEncoding encoding)
+{
+    switch (encoding) {
+    case ContentEncoding::Identity: return "identity";
+    case ContentEncoding::Gzip:     return "gzip";
+    case ContentEncoding::Deflate:  return "deflate";
+    case ContentEncoding::Zstd:     return "zstd";
+    }
+    return {};
+}
+
+std::optional<ContentEncoding> fromToken(QByteArrayView token)
+{
+    const QByteArray t = token.trimmed().toByteArray().toLower();
+    if (t.isEmpty() || t == "identity") return ContentEncoding::Identity;
+    if (t == "gzip" || t == "x-gzip")   return ContentEncoding::Gzip;
+    if (t == "deflate")                 return ContentEncoding::Deflate;
+    if (t == "zstd")                    return ContentEncoding::Zstd;
+    return std::nullopt;
+}
+
+bool isSupported(ContentEncoding encoding)
+{
+    switch (encoding) {
+    case ContentEncoding::Identity:
+        return true;
+    case ContentEncoding::Gzip:
+    case ContentEncoding::Deflate:
+#ifdef HTTPCLIENT_HAS_ZLIB
+        return true;
+#else
+        return false;
+#endif
+    case ContentEncoding::Zstd:
+#ifdef HTTPCLIENT_HAS_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+QByteArray acceptEncodingHeader(const QList<ContentEncoding>& encodings)
+{
+    QByteArray header;
+    int rank = 0;
+
+    for (ContentEncoding encoding : encodings) {
+        if (!isSupported(encoding)) continue;
+
+        if (!header.isEmpty()) header += ", ";
+        header += token(encoding);
+
+        // q decreases by 0.1 per position, floored at 0.1
+        if (rank > 0) header += ";q=0." + QByteArray::number(qMax(1, 10 - rank));
+        ++rank;
+    }
+    return header;
+}
+
+std::optional<QByteArray> compress(ContentEncoding encoding, QByteArrayView data, int level)
+{
+    switch (encoding) {
+    case ContentEncoding::Identity:
+        return data.toByteArray();
+#ifdef HTTPCLIENT_HAS_ZLIB
+    case ContentEncoding::Gzip:
+        return zlibCompress(data, kGzipWindow, level);
+    case ContentEncoding::Deflate:
+        return zlibCompress(data, kZlibWindow, level);
+#else
+    case ContentEncoding::Gzip:
+    case ContentEncoding::Deflate:
+        return std::nullopt;
+#endif
+    case ContentEncoding::Zstd:
+#ifdef HTTPCLIENT_HAS_ZSTD
+    {
+        QByteArray out;
+        out.resize(qsizetype(ZSTD_compressBound(size_t(data.size()))));
+        const size_t written = ZSTD_compress(out.data(), size_t(out.size()), data.data(), size_t(data.size()),
+                                             level < 0 ? ZSTD_CLEVEL_DEFAULT : level);
+        if (ZSTD_isError(written)) return std::nullopt;
+        out.resize(qsizetype(written));
+        return out;
+    }
+#else
+        return std::nullopt;
+#endif
+    }
+    return std::nullopt;
+}
+
+} // namespace HttpCompression
+
+std::unique_ptr<StreamDecoder> StreamDecoder::create(ContentEncoding encoding)
+{
+    switch (encoding) {
+    case ContentEncoding::Identity:
+        return std::make_unique<IdentityDecoder>();
+    case ContentEncoding::Gzip:
+    case ContentEncoding::Deflate:
+#ifdef HTTPCLIENT_HAS_ZLIB
+        return std::make_unique<ZlibDecoder>();
+#else
+        return nullptr;
+#endif
+    case ContentEncoding::Zstd:
+#ifdef HTTPCLIENT_HAS_ZSTD
+        return std::make_unique<ZstdDecoder>();
+#else
+        return nullptr;
+#endif
+    }
+    return nullptr;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <memory>
+#include <optional>
+
+enum class ContentEncoding {
+    Identity,
+    Gzip,    // gzip/deflate only when built with zlib (HTTPCLIENT_HAS_ZLIB)
+    Deflate,
+    Zstd     // only when built with libzstd (HTTPCLIENT_HAS_ZSTD)
+};
+
+struct CompressionOptions {
+    // Request bodies (opt-in): compressed when at least minRequestBytes long
+    ContentEncoding requestEncoding = ContentEncoding::Identity;
+    qint64 minRequestBytes = 1024;
+    int level = -1; // -1 = codec default
+
+    // Response encodings in preference order. Empty keeps Qt's own
+    // Accept-Encoding handling; otherwise HttpClient decodes the body itself.
+    QList<ContentEncoding> acceptEncodings;
+};
+
+namespace HttpCompression {
+
+QByteArray token(ContentEncoding encoding);
+std::optional<ContentEncoding> fromToken(QByteArrayView token);
+bool isSupported(ContentEncoding encoding);
+
+// e.g. "zstd, gzip;q=0.9, deflate;q=0.8"
+QByteArray acceptEncodingHeader(const QList<ContentEncoding>& encodings);
+
+// nullopt when the codec is unavailable or fails
+std::optional<QByteArray> compress(ContentEncoding encoding, QByteArrayView data, int level = -1);
+
+} // namespace HttpCompression
+
+// Incremental decoder fed with body chunks as they arrive on the wire
+class StreamDecoder
+{
+public:
+    static std::unique_ptr<StreamDecoder> create(ContentEncoding encoding);
+
+    virtual ~StreamDecoder() = default;
+
+    // Appends decoded bytes to `out`; false on corrupt input
+    virtual bool feed(QByteArrayView chunk, QByteArray& out) = 0;
+
+    // False when the stream ended early or was corrupt
+    virtual bool finish() = 0;
+};
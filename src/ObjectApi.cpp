@@ -2,7 +2,7 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 
-void ObjectApi::getMany(std::function<void(const QVariantList&)> successCb, ErrorCb errorCb)
+void ObjectApi::getMany(Callback<void(const QVariantList&)> successCb, ErrorCb errorCb)
 {
     if (!ensureClient(errorCb)) return;
 
@@ -16,7 +16,17 @@ void ObjectApi::getMany(std::function<void(const QVariantList&)> successCb, Erro
     });
 }
 
-void ObjectApi::get(const QString& id, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb)
+PagedCursor* ObjectApi::getPaged()
+{
+    return getPaged(PageOptions{});
+}
+
+PagedCursor* ObjectApi::getPaged(const PageOptions& options)
+{
+    return new PagedCursor(client(), "objects", options, this);
+}
+
+void ObjectApi::get(const QString& id, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb)
 {
     if (!ensureClient(errorCb)) return;
 
@@ -30,7 +40,7 @@ void ObjectApi::get(const QString& id, std::function<void(const QVariantMap&)> s
     });
 }
 
-void ObjectApi::post(const QVariantMap& obj, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb)
+void ObjectApi::post(const QVariantMap& obj, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb)
 {
     if (!ensureClient(errorCb)) return;
 
@@ -46,7 +56,7 @@ void ObjectApi::post(const QVariantMap& obj, std::function<void(const QVariantMa
     });
 }
 
-void ObjectApi::put(const QString& id, const QVariantMap& obj, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb)
+void ObjectApi::put(const QString& id, const QVariantMap& obj, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb)
 {
     if (!ensureClient(errorCb)) return;
 
@@ -62,7 +72,7 @@ void ObjectApi::put(const QString& id, const QVariantMap& obj, std::function<voi
     });
 }
 
-void ObjectApi::patch(const QString& id, const QVariantMap& obj, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb)
+void ObjectApi::patch(const QString& id, const QVariantMap& obj, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb)
 {
     if (!ensureClient(errorCb)) return;
 
@@ -78,7 +88,7 @@ void ObjectApi::patch(const QString& id, const QVariantMap& obj, std::function<v
     });
 }
 
-void ObjectApi::remove(const QString& id, std::function<void(bool)> successCb, ErrorCb errorCb)
+void ObjectApi::remove(const QString& id, Callback<void(bool)> successCb, ErrorCb errorCb)
 {
     if (!ensureClient(errorCb)) return;
 
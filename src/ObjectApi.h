@@ -3,9 +3,10 @@
 
 #include <QVariantList>
 #include <QVariantMap>
-#include <functional>
 
 #include "BaseApi.h"
+#include "Callback.h"
+#include "PagedCursor.h"
 
 class ObjectApi : public BaseApi
 {
@@ -15,12 +16,16 @@ public:
     explicit ObjectApi(HttpClient* client, QObject* parent = nullptr)
         : BaseApi(client, parent) {}
 
-    void getMany(std::function<void(const QVariantList&)> successCb, ErrorCb errorCb);
-    void get(const QString& id, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb);
-    void post(const QVariantMap& obj, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb);
-    void put(const QString& id, const QVariantMap& obj, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb);
-    void patch(const QString& id, const QVariantMap& obj, std::function<void(const QVariantMap&)> successCb, ErrorCb errorCb);
-    void remove(const QString& id, std::function<void(bool)> successCb, ErrorCb errorCb);
+    void getMany(Callback<void(const QVariantList&)> successCb, ErrorCb errorCb);
+    // The cursor is parented to this ObjectApi; deleteLater() it when done,
+    // otherwise every cursor lives as long as the API object
+    PagedCursor* getPaged();
+    PagedCursor* getPaged(const PageOptions& options);
+    void get(const QString& id, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb);
+    void post(const QVariantMap& obj, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb);
+    void put(const QString& id, const QVariantMap& obj, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb);
+    void patch(const QString& id, const QVariantMap& obj, Callback<void(const QVariantMap&)> successCb, ErrorCb errorCb);
+    void remove(const QString& id, Callback<void(bool)> successCb, ErrorCb errorCb);
 };
 
 #endif // OBJECTAPI_H
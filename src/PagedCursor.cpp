@@ -0,0 +1,358 @@
+#include "PagedCursor.h"
+
+#include <QHttpHeaders>
+#include <QUrlQuery>
+#include <utility>
+
+PagedCursor::PagedCursor(HttpClient* client, const QString& path, const PageOptions& options, QObject* parent)
+    : BaseApi(client, parent)
+    , m_path(path)
+    , m_options(options)
+{
+    m_options.pageSize = qMax(1, m_options.pageSize);
+    m_options.prefetchDepth = qMax(0, m_options.prefetchDepth);
+    m_pageSize = m_options.pageSize;
+}
+
+PagedCursor::~PagedCursor()
+{
+    abortInFlight();
+}
+
+void PagedCursor::next(PageCb pageCb, ErrorCb errorCb)
+{
+    if (m_waiter) {
+        emitError(errorCb, ErrorResult{0, "A page request is already pending", nullptr});
+        return;
+    }
+    if (atEnd()) {
+        emitError(errorCb, ErrorResult{0, "No more pages", nullptr});
+        return;
+    }
+    if (!ensureClient(errorCb)) return;
+
+    m_waiter = Waiter{std::move(pageCb), std::move(errorCb)};
+
+    // The consumer has seen this page's error and asks again: retry it
+    auto failed = m_failed.find(m_consumeIndex);
+    if (failed != m_failed.end() && failed->reported) {
+        const PageRequest request = failed->request;
+        m_failed.erase(failed);
+        fetch(m_consumeIndex, request);
+    }
+
+    pump();
+    deliver();
+}
+
+bool PagedCursor::atEnd() const
+{
+    return m_lastIndex >= 0 && m_consumeIndex > m_lastIndex;
+}
+
+void PagedCursor::reset()
+{
+    std::optional<Waiter> waiter = std::exchange(m_waiter, std::nullopt);
+
+    abortInFlight();
+    m_pages.clear();
+    m_failed.clear();
+    m_nextUrl.clear();
+    m_nextIndex = 0;
+    m_consumeIndex = 0;
+    m_lastIndex = -1;
+    m_pageSize = m_options.pageSize;
+    m_offsetBaseIndex = 0;
+    m_offsetBase = 0;
+
+    // Reported after the state is cleared, so the callback may call next()
+    if (waiter)
+        emitError(waiter->errorCb, ErrorResult{0, "Cursor reset", nullptr});
+}
+
+void PagedCursor::pump()
+{
+    if (!client()) return;
+
+    // Window = the page the consumer is waiting for + prefetchDepth ahead
+    while (m_nextIndex - m_consumeIndex <= m_options.prefetchDepth) {
+        if (m_lastIndex >= 0 && m_nextIndex > m_lastIndex) return;
+
+        // Cursor/link pages are chained: the next url is only known once
+        // the previous page has arrived
+        if (m_options.style != PageOptions::Style::OffsetLimit
+            && (!m_inFlight.isEmpty() || (m_nextIndex > 0 && m_nextUrl.isEmpty())))
+            return;
+
+        const int index = m_nextIndex++;
+        const PageRequest request = pageRequest(index);
+        m_nextUrl.clear();
+        fetch(index, request);
+    }
+}
+
+void PagedCursor::fetch(int index, const PageRequest& request)
+{
+    if (request.url.isEmpty() || !QUrl(request.url).isValid()) {
+        failPage(index, request, ErrorResult{0, "Invalid URL", nullptr});
+        return;
+    }
+
+    const quint64 serial = ++m_serial;
+    RequestHandle* handle = client()->get(request.url, [this, index, serial](QRestReply& reply) {
+        onPage(index, serial, reply);
+    }, m_options.retryPolicy);
+
+    // Covers failures that never reach the callback (e.g. a url HttpClient
+    // cannot resolve). Queued, so a reply seen by onPage wins.
+    connect(handle, &RequestHandle::failed, this, [this, index, serial](const QString& message, int httpStatus) {
+        onFailed(index, serial, message, httpStatus);
+    }, Qt::QueuedConnection);
+
+    m_inFlight.insert(index, InFlight{handle, request, serial});
+}
+
+void PagedCursor::onPage(int index, quint64 serial, QRestReply& reply)
+{
+    const auto current = m_inFlight.constFind(index);
+    if (current == m_inFlight.cend() || current->serial != serial) return;
+
+    const PageRequest request = current->request;
+    m_inFlight.erase(current);
+
+    ErrorCb onError = [this, index, &request](const ErrorResult& err) { failPage(index, request, err); };
+
+    withJson(reply, onError, [&](const QJsonDocument& doc) {
+        QJsonArray items;
+        QJsonObject body;
+
+        if (doc.isArray()) {
+            items = doc.array();
+        } else {
+            body = doc.object();
+            const QJsonValue value = body.value(m_options.itemsField);
+            if (!value.isArray()) {
+                emitError(onError, fromReply(reply, "Unexpected JSON type"));
+                return;
+            }
+            items = value.toArray();
+        }
+
+        // Offset pages may land out of order; anything past the end is dropped
+        if (m_lastIndex >= 0 && index > m_lastIndex) return;
+
+        bool last = false;
+        switch (m_options.style) {
+        case PageOptions::Style::OffsetLimit: {
+            const qsizetype count = items.size();
+            switch (m_options.endRule) {
+            case PageOptions::EndRule::ShortPage:
+                last = count < m_pageSize;
+                break;
+            case PageOptions::EndRule::EmptyPage:
+                last = count == 0;
+                break;
+            case PageOptions::EndRule::TotalCount: {
+                const qint64 total = totalCount(reply, body);
+                last = count == 0 || (total >= 0 && request.offset + count >= total);
+                break;
+            }
+            }
+
+            // Fewer items than asked but not the end: the server caps limit,
+            // so the following offsets are wrong and have to be re-requested
+            if (!last && count < m_pageSize)
+                rebase(index, request.offset + count, int(count));
+            break;
+        }
+        case PageOptions::Style::Cursor: {
+            const QString token = body.value(m_options.nextCursorField).toString();
+            last = token.isEmpty();
+            if (!last) m_nextUrl = withQuery({
+                { m_options.cursorParam, token },
+                { m_options.limitParam, QString::number(m_options.pageSize) }
+            });
+            break;
+        }
+        case PageOptions::Style::LinkHeader:
+            m_nextUrl = nextLink(reply);
+            last = m_nextUrl.isEmpty();
+            break;
+        }
+
+        if (last) {
+            m_lastIndex = index;
+            dropAfter(index);
+            m_nextIndex = index + 1;
+        }
+
+        m_pages.insert(index, items.toVariantList());
+    });
+
+    pump();
+    deliver();
+}
+
+void PagedCursor::onFailed(int index, quint64 serial, const QString& message, int httpStatus)
+{
+    const auto current = m_inFlight.constFind(index);
+    if (current == m_inFlight.cend() || current->serial != serial) return;
+
+    const PageRequest request = current->request;
+    m_inFlight.erase(current);
+
+    failPage(index, request, ErrorResult{httpStatus, message, nullptr});
+    pump();
+    deliver();
+}
+
+void PagedCursor::failPage(int index, const PageRequest& request, const ErrorResult& err)
+{
+    if (m_lastIndex >= 0 && index > m_lastIndex) return;
+    m_failed.insert(index, Failure{err, request});
+}
+
+void PagedCursor::deliver()
+{
+    if (!m_waiter) return;
+
+    // Errors are reported in page order, once each
+    auto failed = m_failed.find(m_consumeIndex);
+    if (failed != m_failed.end()) {
+        if (failed->reported) return;
+        failed->reported = true;
+
+        Waiter waiter = std::move(*m_waiter);
+        m_waiter.reset();
+        emitError(waiter.errorCb, failed->error);
+        return;
+    }
+
+    auto it = m_pages.find(m_consumeIndex);
+    if (it == m_pages.end()) return;
+
+    // Evict on hand-out so consumed pages never accumulate
+    const QVariantList items = std::move(it.value());
+    m_pages.erase(it);
+    ++m_consumeIndex;
+
+    Waiter waiter = std::move(*m_waiter);
+    m_waiter.reset();
+
+    pump();
+
+    if (waiter.pageCb) waiter.pageCb(items);
+}
+
+void PagedCursor::rebase(int index, qint64 nextOffset, int pageSize)
+{
+    m_pageSize = qMax(1, pageSize);
+    m_offsetBaseIndex = index + 1;
+    m_offsetBase = nextOffset;
+
+    dropAfter(index);
+    m_nextIndex = index + 1;
+    if (m_lastIndex > index)
+        m_lastIndex = -1;
+}
+
+void PagedCursor::dropAfter(int index)
+{
+    for (auto it = m_inFlight.begin(); it != m_inFlight.end();) {
+        if (it.key() > index) {
+            if (it->handle) it->handle->abort();
+            it = m_inFlight.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    while (!m_pages.isEmpty() && m_pages.lastKey() > index)
+        m_pages.remove(m_pages.lastKey());
+    while (!m_failed.isEmpty() && m_failed.lastKey() > index)
+        m_failed.remove(m_failed.lastKey());
+}
+
+void PagedCursor::abortInFlight()
+{
+    for (const InFlight& page : std::as_const(m_inFlight)) {
+        if (page.handle) page.handle->abort();
+    }
+    m_inFlight.clear();
+}
+
+PagedCursor::PageRequest PagedCursor::pageRequest(int index) const
+{
+    if (m_options.style == PageOptions::Style::OffsetLimit) {
+        const qint64 offset = m_offsetBase + qint64(index - m_offsetBaseIndex) * m_pageSize;
+        return PageRequest{
+            withQuery({
+                { m_options.offsetParam, QString::number(offset) },
+                { m_options.limitParam, QString::number(m_pageSize) }
+            }),
+            offset
+        };
+    }
+
+    if (index == 0)
+        return PageRequest{ withQuery({ { m_options.limitParam, QString::number(m_options.pageSize) } }) };
+
+    return PageRequest{ m_nextUrl };
+}
+
+QString PagedCursor::withQuery(const QList<std::pair<QString, QString>>& items) const
+{
+    QUrl url(m_path);
+    QUrlQuery query(url);
+    for (const auto& [key, value] : items) {
+        query.removeAllQueryItems(key);
+        // QUrlQuery leaves '+' alone, which servers read as a space; opaque
+        // tokens (often base64) need it as %2B
+        query.addQueryItem(key, QString::fromLatin1(QUrl::toPercentEncoding(value)));
+    }
+    url.setQuery(query);
+    return url.toString();
+}
+
+qint64 PagedCursor::totalCount(QRestReply& reply, const QJsonObject& body) const
+{
+    const QJsonValue field = body.value(m_options.totalField);
+    if (field.isDouble())
+        return field.toInteger(-1);
+
+    QNetworkReply* networkReply = reply.networkReply();
+    if (!networkReply || m_options.totalHeader.isEmpty()) return -1;
+
+    const QHttpHeaders headers = networkReply->headers();
+    bool ok = false;
+    const qint64 total = headers.combinedValue(m_options.totalHeader).trimmed().toLongLong(&ok);
+    return ok ? total : -1;
+}
+
+QString PagedCursor::nextLink(QRestReply& reply)
+{
+    QNetworkReply* networkReply = reply.networkReply();
+    if (!networkReply) return {};
+
+    // Link: <https://host/objects?page=2>; rel="next", <...>; rel="last"
+    const QHttpHeaders headers = networkReply->headers();
+    const QString header = QString::fromUtf8(headers.combinedValue(QHttpHeaders::WellKnownHeader::Link));
+
+    for (const QString& entry : header.split(',', Qt::SkipEmptyParts)) {
+        const QStringList parts = entry.split(';');
+        const QString target = parts.value(0).trimmed();
+        if (!target.startsWith('<') || !target.endsWith('>')) continue;
+
+        for (qsizetype i = 1; i < parts.size(); ++i) {
+            QString param = parts.at(i).trimmed();
+            if (!param.startsWith("rel=", Qt::CaseInsensitive)) continue;
+
+            param = param.mid(4).remove('"');
+            if (param.split(' ', Qt::SkipEmptyParts).contains("next", Qt::CaseInsensitive)) {
+                // Relative targets resolve against the request url
+                const QUrl url = networkReply->url().resolved(QUrl(target.mid(1, target.size() - 2)));
+                return url.toString();
+            }
+        }
+    }
+    return {};
+}
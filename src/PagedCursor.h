@@ -0,0 +1,137 @@
+#ifndef PAGEDCURSOR_H
+#define PAGEDCURSOR_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QPointer>
+#include <QString>
+#include <QVariantList>
+#include <optional>
+
+#include "BaseApi.h"
+#include "Callback.h"
+
+struct PageOptions {
+    enum class Style {
+        OffsetLimit, // ?offset=N&limit=M, end decided by endRule
+        Cursor,      // ?cursor=<token>, token read from the response body
+        LinkHeader   // follows `Link: <url>; rel="next"`
+    };
+
+    // OffsetLimit only: how the last page is recognised
+    enum class EndRule {
+        ShortPage,  // fewer than pageSize items
+        EmptyPage,  // no items; short pages mean the server capped limit
+        TotalCount  // offset + items reaches totalField / totalHeader, else EmptyPage
+    };
+
+    Style style = Style::OffsetLimit;
+    int pageSize = 20;
+    int prefetchDepth = 1; // pages fetched ahead of the consumer, 0 = no prefetch
+
+    QString offsetParam = "offset";
+    QString limitParam = "limit";
+    EndRule endRule = EndRule::ShortPage;
+    QString totalField = "total";              // looked up in an object body
+    QByteArray totalHeader = "X-Total-Count";  // used when the body has no totalField
+
+    QString cursorParam = "cursor";
+    QString nextCursorField = "next_cursor";
+
+    QString itemsField = "data"; // used when a page body is an object instead of an array
+
+    SharedRetryPolicy retryPolicy; // per page request, nullptr = no retries
+};
+
+// Pulls a collection page by page. While the consumer handles page N, up to
+// `prefetchDepth` following pages are fetched in the background. Pages are
+// dropped as soon as they are handed out, so memory stays bounded by the
+// prefetch window regardless of the collection size.
+//
+// A failed page is reported when the consumer reaches it; pages before it
+// are still delivered. Calling next() again after that error fetches the
+// page once more.
+class PagedCursor : public BaseApi
+{
+    Q_OBJECT
+
+public:
+    using PageCb = Callback<void(const QVariantList&)>;
+
+    PagedCursor(HttpClient* client, const QString& path, const PageOptions& options, QObject* parent = nullptr);
+    ~PagedCursor() override;
+
+    // Delivers the next page. Only one call may be pending at a time.
+    // With OffsetLimit the last page may be empty when the collection size
+    // is a multiple of pageSize.
+    void next(PageCb pageCb, ErrorCb errorCb);
+
+    bool atEnd() const;
+    int bufferedPages() const { return m_pages.size(); }
+    const PageOptions& options() const { return m_options; }
+
+    // Starts over from the first page; a pending next() gets "Cursor reset"
+    void reset();
+
+private:
+    struct Waiter {
+        PageCb pageCb;
+        ErrorCb errorCb;
+    };
+
+    struct PageRequest {
+        QString url;
+        qint64 offset = -1; // OffsetLimit only
+    };
+
+    struct InFlight {
+        QPointer<RequestHandle> handle;
+        PageRequest request;
+        quint64 serial = 0; // tells a stale reply from the current request for that index
+    };
+
+    struct Failure {
+        ErrorResult error;
+        PageRequest request; // fetched again once the error has been reported
+        bool reported = false;
+    };
+
+    void pump();
+    void fetch(int index, const PageRequest& request);
+    void onPage(int index, quint64 serial, QRestReply& reply);
+    void onFailed(int index, quint64 serial, const QString& message, int httpStatus);
+    void failPage(int index, const PageRequest& request, const ErrorResult& err);
+    void deliver();
+    void rebase(int index, qint64 nextOffset, int pageSize);
+    void dropAfter(int index);
+    void abortInFlight();
+
+    PageRequest pageRequest(int index) const;
+    QString withQuery(const QList<std::pair<QString, QString>>& items) const;
+    qint64 totalCount(QRestReply& reply, const QJsonObject& body) const;
+    static QString nextLink(QRestReply& reply);
+
+private:
+    QString m_path;
+    PageOptions m_options;
+
+    int m_nextIndex = 0;    // next page to request
+    int m_consumeIndex = 0; // next page to hand out
+    int m_lastIndex = -1;   // index of the final page once known
+    QString m_nextUrl;      // Cursor/LinkHeader: url of page m_nextIndex
+
+    // OffsetLimit: page i starts at m_offsetBase + (i - m_offsetBaseIndex) * m_pageSize.
+    // Moved when the server returns fewer items than asked without being at the end.
+    int m_pageSize = 0;
+    int m_offsetBaseIndex = 0;
+    qint64 m_offsetBase = 0;
+
+    quint64 m_serial = 0;
+
+    QMap<int, QVariantList> m_pages;
+    QMap<int, Failure> m_failed;
+    QMap<int, InFlight> m_inFlight;
+    std::optional<Waiter> m_waiter;
+};
+
+#endif // PAGEDCURSOR_H
@@ -0,0 +1,78 @@
+#include "ReplayNetworkAccessManager.h"
+
+#include <QDebug>
+#include <QTimer>
+#include <cmath>
+
+#include "BufferedReply.h"
+
+ReplayNetworkAccessManager::ReplayNetworkAccessManager(const TrafficRecording& recording, QObject* parent)
+    : QNetworkAccessManager(parent)
+    , m_entries(recording.entries)
+{
+    for (qsizetype i = 0; i < m_entries.size(); ++i)
+        m_byKey[key(m_entries.at(i).method, m_entries.at(i).url)].append(i);
+}
+
+void ReplayNetworkAccessManager::setSpeed(double speed)
+{
+    // Also catches NaN
+    if (!(speed >= 0)) {
+        qWarning() << "ReplayNetworkAccessManager: speed must be >= 0, ignoring" << speed;
+        return;
+    }
+    m_speed = speed;
+}
+
+void ReplayNetworkAccessManager::rewind()
+{
+    m_cursor.clear();
+    m_misses = 0;
+}
+
+QNetworkReply* ReplayNetworkAccessManager::createRequest(Operation op, const QNetworkRequest& request, QIODevice* outgoingData)
+{
+    Q_UNUSED(outgoingData);
+
+    auto* reply = new BufferedReply(this);
+    reply->setRequestInfo(op, request);
+
+    const QByteArray method = TrafficEntry::methodName(op, request);
+    const QByteArray k = key(method, request.url());
+
+    const TrafficEntry* entry = nullptr;
+    const auto it = m_byKey.constFind(k);
+    if (it != m_byKey.constEnd()) {
+        qsizetype& pos = m_cursor[k];
+        if (pos >= it->size() && m_loop)
+            pos = 0;
+        if (pos < it->size())
+            entry = &m_entries.at(it->at(pos++));
+    }
+
+    qint64 delayMs = 0;
+    if (entry) {
+        reply->setReplyHeaders(entry->responseHeaders);
+        reply->setHttpStatus(entry->status, entry->reason);
+        reply->setContent(entry->responseBody);
+        if (entry->error != QNetworkReply::NoError)
+            reply->setReplyError(entry->error, entry->errorString);
+
+        if (m_speed > 0)
+            delayMs = qMax<qint64>(0, std::llround(entry->durationMs / m_speed)); // durationMs comes from a file
+    } else {
+        ++m_misses;
+        reply->setReplyError(QNetworkReply::ContentNotFoundError,
+                             QStringLiteral("No recorded response for %1 %2")
+                                 .arg(QString::fromLatin1(method), request.url().toString()));
+    }
+
+    // Always deferred: callers connect to the reply after this returns
+    QTimer::singleShot(delayMs, reply, &BufferedReply::complete);
+    return reply;
+}
+
+QByteArray ReplayNetworkAccessManager::key(const QByteArray& method, const QUrl& url)
+{
+    return method.toUpper() + ' ' + url.adjusted(QUrl::NormalizePathSegments).toEncoded();
+}
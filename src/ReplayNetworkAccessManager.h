@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QHash>
+#include <QNetworkAccessManager>
+
+#include "TrafficRecorder.h"
+
+// Serves a TrafficRecording in-process instead of touching the network.
+// Requests are matched on method + full url; repeated requests for the same
+// key get the recorded responses in order. Pass it to HttpClient's
+// manager constructor to run the client layer against recorded traffic.
+class ReplayNetworkAccessManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+
+public:
+    explicit ReplayNetworkAccessManager(const TrafficRecording& recording, QObject* parent = nullptr);
+
+    // 1.0 = recorded latency, 2.0 = twice as fast, 0 = respond immediately.
+    // Negative values are rejected.
+    void setSpeed(double speed);
+    double speed() const { return m_speed; }
+
+    // Start over from the first match once a key's responses are used up
+    void setLoop(bool loop) { m_loop = loop; }
+    bool loop() const { return m_loop; }
+
+    void rewind();
+
+    int misses() const { return m_misses; }
+
+protected:
+    QNetworkReply* createRequest(Operation op, const QNetworkRequest& request, QIODevice* outgoingData = nullptr) override;
+
+private:
+    static QByteArray key(const QByteArray& method, const QUrl& url);
+
+private:
+    QList<TrafficEntry> m_entries;
+    QHash<QByteArray, QList<qsizetype>> m_byKey; // key -> indexes into m_entries
+    QHash<QByteArray, qsizetype> m_cursor;       // key -> next position in m_byKey
+    double m_speed = 1.0;
+    bool m_loop = false;
+    int m_misses = 0;
+};
@@ -0,0 +1,267 @@
+#include "TrafficRecorder.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QUtf8StringView>
+
+#include "BufferedReply.h"
+
+namespace {
+
+QJsonArray headersToJson(const QHttpHeaders& headers)
+{
+    QJsonArray arr;
+    for (qsizetype i = 0; i < headers.size(); ++i) {
+        arr.append(QJsonObject{
+            { "name", QString(headers.nameAt(i)) },
+            { "value", QString::fromUtf8(headers.valueAt(i)) }
+        });
+    }
+    return arr;
+}
+
+QHttpHeaders headersFromJson(const QJsonArray& arr)
+{
+    QHttpHeaders headers;
+    for (const QJsonValue& v : arr) {
+        const QJsonObject h = v.toObject();
+        headers.append(h.value("name").toString(), h.value("value").toString());
+    }
+    return headers;
+}
+
+// HAR `content`/`postData` style: text, or base64 with "encoding"
+QJsonObject bodyToJson(const QByteArray& body, const QHttpHeaders& headers)
+{
+    QJsonObject obj{
+        { "size", body.size() },
+        { "mimeType", QString::fromUtf8(headers.combinedValue(QHttpHeaders::WellKnownHeader::ContentType)) }
+    };
+
+    if (QUtf8StringView(body).isValidUtf8()) {
+        obj.insert("text", QString::fromUtf8(body));
+    } else {
+        obj.insert("text", QString::fromLatin1(body.toBase64()));
+        obj.insert("encoding", "base64");
+    }
+    return obj;
+}
+
+QByteArray bodyFromJson(const QJsonObject& obj)
+{
+    const QString text = obj.value("text").toString();
+    if (obj.value("encoding").toString() == "base64")
+        return QByteArray::fromBase64(text.toLatin1());
+    return text.toUtf8();
+}
+
+QJsonObject entryToJson(const TrafficEntry& e)
+{
+    QJsonObject response{
+        { "status", e.status },
+        { "statusText", QString::fromUtf8(e.reason) },
+        { "headers", headersToJson(e.responseHeaders) },
+        { "content", bodyToJson(e.responseBody, e.responseHeaders) }
+    };
+    if (e.error != QNetworkReply::NoError) {
+        response.insert("_error", int(e.error));
+        response.insert("_errorString", e.errorString);
+    }
+
+    QJsonObject request{
+        { "method", QString::fromLatin1(e.method) },
+        { "url", e.url.toString(QUrl::FullyEncoded) },
+        { "headers", headersToJson(e.requestHeaders) }
+    };
+    if (!e.requestBody.isEmpty())
+        request.insert("postData", bodyToJson(e.requestBody, e.requestHeaders));
+
+    return QJsonObject{
+        { "startedDateTime", e.startedAt.toString(Qt::ISODateWithMs) },
+        { "time", e.durationMs },
+        { "_startOffset", e.startOffsetMs },
+        { "request", request },
+        { "response", response }
+    };
+}
+
+TrafficEntry entryFromJson(const QJsonObject& obj)
+{
+    const QJsonObject request = obj.value("request").toObject();
+    const QJsonObject response = obj.value("response").toObject();
+
+    TrafficEntry e;
+    e.startedAt = QDateTime::fromString(obj.value("startedDateTime").toString(), Qt::ISODateWithMs);
+    e.durationMs = qint64(obj.value("time").toDouble());
+    e.startOffsetMs = qint64(obj.value("_startOffset").toDouble());
+
+    e.method = request.value("method").toString().toLatin1();
+    e.url = QUrl(request.value("url").toString(), QUrl::StrictMode);
+    e.requestHeaders = headersFromJson(request.value("headers").toArray());
+    e.requestBody = bodyFromJson(request.value("postData").toObject());
+
+    e.status = response.value("status").toInt();
+    e.reason = response.value("statusText").toString().toUtf8();
+    e.responseHeaders = headersFromJson(response.value("headers").toArray());
+    e.responseBody = bodyFromJson(response.value("content").toObject());
+    e.error = QNetworkReply::NetworkError(response.value("_error").toInt(QNetworkReply::NoError));
+    e.errorString = response.value("_errorString").toString();
+    return e;
+}
+
+} // namespace
+
+QByteArray TrafficEntry::methodName(QNetworkAccessManager::Operation op, const QNetworkRequest& request)
+{
+    switch (op) {
+    case QNetworkAccessManager::HeadOperation:   return "HEAD";
+    case QNetworkAccessManager::GetOperation:    return "GET";
+    case QNetworkAccessManager::PutOperation:    return "PUT";
+    case QNetworkAccessManager::PostOperation:   return "POST";
+    case QNetworkAccessManager::DeleteOperation: return "DELETE";
+    case QNetworkAccessManager::CustomOperation:
+        return request.attribute(QNetworkRequest::CustomVerbAttribute).toByteArray();
+    default:
+        return {};
+    }
+}
+
+bool TrafficRecording::save(const QString& path, QString* errorString) const
+{
+    QJsonArray arr;
+    for (const TrafficEntry& e : entries)
+        arr.append(entryToJson(e));
+
+    const QJsonObject root{
+        { "log", QJsonObject{
+            { "version", "1.2" },
+            { "creator", QJsonObject{ { "name", "HttpClient" }, { "version", "1" } } },
+            { "entries", arr }
+        } }
+    };
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0
+        || !file.commit()) {
+        if (errorString) *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+std::optional<TrafficRecording> TrafficRecording::load(const QString& path, QString* errorString)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString) *errorString = file.errorString();
+        return std::nullopt;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (errorString) *errorString = parseError.errorString();
+        return std::nullopt;
+    }
+
+    TrafficRecording recording;
+    const QJsonArray arr = doc.object().value("log").toObject().value("entries").toArray();
+    recording.entries.reserve(arr.size());
+    for (const QJsonValue& v : arr)
+        recording.entries.append(entryFromJson(v.toObject()));
+    return recording;
+}
+
+TrafficRecorder::TrafficRecorder(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void TrafficRecorder::start()
+{
+    if (m_recording) return;
+    m_recording = true;
+    if (!m_clock.isValid()) m_clock.start();
+}
+
+void TrafficRecorder::stop()
+{
+    m_recording = false;
+    m_pending.clear();
+}
+
+void TrafficRecorder::clear()
+{
+    m_pending.clear();
+    m_data.entries.clear();
+    m_clock.invalidate();
+    if (m_recording) m_clock.start();
+}
+
+int TrafficRecorder::begin(const QNetworkReply* reply, const QByteArray& requestBody)
+{
+    if (!m_recording || !reply) return -1;
+
+    const QNetworkRequest request = reply->request();
+
+    TrafficEntry e;
+    e.startedAt = QDateTime::currentDateTimeUtc();
+    e.startOffsetMs = m_clock.elapsed();
+    e.method = TrafficEntry::methodName(reply->operation(), request);
+    e.url = request.url();
+    e.requestHeaders = redact(request.headers());
+    e.requestBody = requestBody;
+
+    // Qt's HTTP backend inflates on its own unless the caller sent
+    // Accept-Encoding; in-memory replies (replay) are never touched
+    const bool qtDecodes = !request.hasRawHeader("Accept-Encoding")
+                           && !qobject_cast<const BufferedReply*>(reply);
+
+    const int id = m_nextId++;
+    m_pending.insert(id, Pending{std::move(e), reply, qtDecodes});
+    return id;
+}
+
+void TrafficRecorder::finish(int id, QNetworkReply* reply)
+{
+    auto it = m_pending.find(id);
+    if (it == m_pending.end()) return;
+
+    Pending pending = std::move(it.value());
+    m_pending.erase(it);
+    if (!reply) return;
+
+    TrafficEntry& e = pending.entry;
+    e.durationMs = m_clock.elapsed() - e.startOffsetMs;
+    e.status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    e.reason = reply->attribute(QNetworkRequest::HttpReasonPhraseAttribute).toByteArray();
+    e.responseHeaders = redact(reply->headers());
+    e.responseBody = reply->peek(reply->bytesAvailable());
+
+    // The body is stored as the caller saw it, so the headers must describe
+    // that body and not the wire one, or a replay would try to inflate it again
+    const QByteArray encoding = e.responseHeaders.combinedValue(QHttpHeaders::WellKnownHeader::ContentEncoding).trimmed();
+    const bool encoded = !encoding.isEmpty() && encoding.compare("identity", Qt::CaseInsensitive) != 0;
+    if (reply != pending.wireReply || (pending.qtDecodes && encoded)) {
+        e.responseHeaders.removeAll(QHttpHeaders::WellKnownHeader::ContentEncoding);
+        e.responseHeaders.removeAll(QHttpHeaders::WellKnownHeader::ContentLength);
+    }
+
+    e.error = reply->error();
+    if (e.error != QNetworkReply::NoError)
+        e.errorString = reply->errorString();
+
+    m_data.entries.append(std::move(pending.entry));
+}
+
+QHttpHeaders TrafficRecorder::redact(const QHttpHeaders& headers) const
+{
+    QHttpHeaders out = headers;
+    for (const QByteArray& name : m_redacted)
+        out.removeAll(QLatin1StringView(name));
+    return out;
+}
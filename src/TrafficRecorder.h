@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QHttpHeaders>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+#include <QUrl>
+#include <optional>
+
+struct TrafficEntry {
+    QDateTime startedAt;
+    qint64 startOffsetMs = 0; // since recording started
+    qint64 durationMs = 0;    // request sent -> reply finished
+
+    QByteArray method;
+    QUrl url;
+    QHttpHeaders requestHeaders;
+    QByteArray requestBody;
+
+    int status = 0;
+    QByteArray reason;
+    QHttpHeaders responseHeaders;
+    QByteArray responseBody;
+
+    QNetworkReply::NetworkError error = QNetworkReply::NoError;
+    QString errorString;
+
+    static QByteArray methodName(QNetworkAccessManager::Operation op, const QNetworkRequest& request);
+};
+
+// HAR-like JSON file ({"log": {"entries": [...]}}); bodies that are not
+// valid UTF-8 are stored base64-encoded
+struct TrafficRecording {
+    QList<TrafficEntry> entries;
+
+    bool save(const QString& path, QString* errorString = nullptr) const;
+    static std::optional<TrafficRecording> load(const QString& path, QString* errorString = nullptr);
+};
+
+// Captures request/response pairs passing through HttpClient
+// (see HttpClient::setRecorder)
+class TrafficRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TrafficRecorder(QObject* parent = nullptr);
+
+    void start();
+    void stop();
+    bool isRecording() const { return m_recording; }
+
+    // Lower-case header names left out of the file, credentials by default
+    void setRedactedHeaders(const QList<QByteArray>& names) { m_redacted = names; }
+
+    // Returns an id for finish(), or -1 when not recording
+    int begin(const QNetworkReply* reply, const QByteArray& requestBody);
+
+    // `reply` is what the caller sees: its body is peeked, not consumed.
+    // When that body is decoded (by Qt, or a reply other than the one given
+    // to begin()), Content-Encoding and Content-Length are not recorded.
+    void finish(int id, QNetworkReply* reply);
+
+    const TrafficRecording& recording() const { return m_data; }
+    void clear();
+
+private:
+    struct Pending {
+        TrafficEntry entry;
+        const QNetworkReply* wireReply = nullptr; // only compared, never dereferenced
+        bool qtDecodes = false; // no Accept-Encoding sent, Qt inflates transparently
+    };
+
+    QHttpHeaders redact(const QHttpHeaders& headers) const;
+
+private:
+    bool m_recording = false;
+    QElapsedTimer m_clock;
+    int m_nextId = 0;
+    QHash<int, Pending> m_pending;
+    TrafficRecording m_data;
+    QList<QByteArray> m_redacted = { "authorization", "cookie", "set-cookie", "proxy-authorization" };
+};
@@ -0,0 +1,168 @@
+#include "TrafficReplayDriver.h"
+
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+TrafficReplayDriver::TrafficReplayDriver(HttpClient* client, const TrafficRecording& recording, QObject* parent)
+    : QObject(parent)
+    , m_client(client)
+    , m_entries(recording.entries)
+{
+    m_order.reserve(m_entries.size());
+    for (int i = 0; i < m_entries.size(); ++i)
+        m_order.append(i);
+    std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b) {
+        return m_entries.at(a).startOffsetMs < m_entries.at(b).startOffsetMs;
+    });
+
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &TrafficReplayDriver::sendDue);
+}
+
+TrafficReplayDriver::~TrafficReplayDriver()
+{
+    stop();
+}
+
+void TrafficReplayDriver::setSpeed(double speed)
+{
+    // Also catches NaN
+    if (!(speed >= 0)) {
+        qWarning() << "TrafficReplayDriver: speed must be >= 0, ignoring" << speed;
+        return;
+    }
+    m_speed = speed;
+}
+
+void TrafficReplayDriver::start()
+{
+    if (m_running) return;
+
+    m_running = true;
+    m_runSpeed = m_speed;
+    ++m_run;
+    m_next = 0;
+    m_inFlight = 0;
+    m_skipped = 0;
+    m_clock.start();
+    sendDue();
+}
+
+void TrafficReplayDriver::stop()
+{
+    if (!m_running) return;
+
+    m_running = false;
+    m_timer.stop();
+    m_inFlight = 0;
+
+    for (const QPointer<RequestHandle>& handle : std::exchange(m_handles, {})) {
+        if (handle) handle->abort();
+    }
+}
+
+void TrafficReplayDriver::sendDue()
+{
+    if (!m_running) return;
+
+    // Several entries may share a due time, or be overdue after a slow tick
+    const qint64 now = m_clock.elapsed();
+    while (m_next < m_order.size() && dueMs(m_next) <= now)
+        send(m_order.at(m_next++));
+
+    if (m_next < m_order.size()) {
+        const qint64 wait = dueMs(m_next) - m_clock.elapsed();
+        m_timer.start(int(qBound<qint64>(0, wait, std::numeric_limits<int>::max())));
+        return;
+    }
+
+    if (m_inFlight == 0) {
+        m_running = false;
+        emit finished();
+    }
+}
+
+void TrafficReplayDriver::send(int index)
+{
+    const TrafficEntry& entry = m_entries.at(index);
+    if (!m_client) {
+        ++m_skipped;
+        return;
+    }
+
+    const QString url = entry.url.toString();
+    const QByteArray method = entry.method.toUpper();
+    const qint64 sentAt = m_clock.elapsed();
+
+    auto onReply = [this, index, sentAt](QRestReply& reply) {
+        emit requestFinished(index, reply.httpStatus(), m_clock.elapsed() - sentAt);
+    };
+
+    RequestHandle* handle = nullptr;
+    if (method == "GET")
+        handle = m_client->get(url, onReply);
+    else if (method == "POST")
+        handle = m_client->post(url, decodedBody(entry), onReply);
+    else if (method == "PUT")
+        handle = m_client->put(url, decodedBody(entry), onReply);
+    else if (method == "PATCH")
+        handle = m_client->patch(url, decodedBody(entry), onReply);
+    else if (method == "DELETE")
+        handle = m_client->remove(url, onReply);
+
+    if (!handle) {
+        qWarning() << "TrafficReplayDriver: skipping unsupported method" << method << url;
+        ++m_skipped;
+        return;
+    }
+
+    // Handles are released on every outcome (incl. invalid url), so their
+    // destruction is what marks a request as done
+    ++m_inFlight;
+    m_handles.append(handle);
+    connect(handle, &QObject::destroyed, this, [this, run = m_run]() {
+        if (run == m_run) requestDone();
+    });
+}
+
+void TrafficReplayDriver::requestDone()
+{
+    if (!m_running) return;
+
+    --m_inFlight;
+    m_handles.removeIf([](const QPointer<RequestHandle>& handle) { return handle.isNull(); });
+
+    if (m_inFlight == 0 && m_next >= m_order.size()) {
+        m_running = false;
+        emit finished();
+    }
+}
+
+qint64 TrafficReplayDriver::dueMs(int position) const
+{
+    if (m_runSpeed <= 0) return 0;
+
+    const qint64 offset = m_entries.at(m_order.at(position)).startOffsetMs
+                          - m_entries.at(m_order.first()).startOffsetMs;
+    return qint64(std::llround(offset / m_runSpeed));
+}
+
+QByteArray TrafficReplayDriver::decodedBody(const TrafficEntry& entry)
+{
+    const QByteArray header = entry.requestHeaders.combinedValue(QHttpHeaders::WellKnownHeader::ContentEncoding);
+    const std::optional<ContentEncoding> encoding = HttpCompression::fromToken(header);
+    if (!encoding || *encoding == ContentEncoding::Identity)
+        return entry.requestBody;
+
+    QByteArray body;
+    const std::unique_ptr<StreamDecoder> decoder = StreamDecoder::create(*encoding);
+    if (!decoder || !decoder->feed(entry.requestBody, body) || !decoder->finish()) {
+        qWarning() << "TrafficReplayDriver: cannot decode" << header << "request body, sending it as recorded";
+        return entry.requestBody;
+    }
+    return body;
+}
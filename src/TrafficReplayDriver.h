@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include "HttpClient.h"
+#include "TrafficRecorder.h"
+
+// Re-issues a recording through an HttpClient on the recorded timeline:
+// entry i is sent (startOffsetMs(i) - startOffsetMs(first)) / speed ms
+// after start(). Together with a recording of production traffic this
+// reproduces its arrival pattern against any server, or against a
+// ReplayNetworkAccessManager for an offline run.
+//
+// Urls are sent as recorded; headers come from the client (bearer, common
+// headers). Bodies recorded with a Content-Encoding are decoded first, so
+// HttpClient's own CompressionOptions apply on resend.
+class TrafficReplayDriver : public QObject
+{
+    Q_OBJECT
+
+public:
+    TrafficReplayDriver(HttpClient* client, const TrafficRecording& recording, QObject* parent = nullptr);
+    ~TrafficReplayDriver() override;
+
+    // 1.0 = recorded pacing, 2.0 = twice as fast, 0 = everything at once.
+    // Negative values are rejected. Takes effect at the next start().
+    void setSpeed(double speed);
+    double speed() const { return m_speed; }
+
+    void start();
+    void stop(); // aborts requests still in flight
+    bool isRunning() const { return m_running; }
+
+    int issued() const { return m_next; } // entries sent or skipped so far
+    int skipped() const { return m_skipped; } // methods HttpClient has no call for
+
+signals:
+    // `index` is the entry's position in the recording
+    void requestFinished(int index, int httpStatus, qint64 latencyMs);
+    void finished();
+
+private:
+    void sendDue();
+    void send(int index);
+    void requestDone();
+    qint64 dueMs(int position) const;
+
+    static QByteArray decodedBody(const TrafficEntry& entry);
+
+private:
+    QPointer<HttpClient> m_client;
+    QList<TrafficEntry> m_entries;
+    QList<int> m_order; // entry indexes sorted by startOffsetMs
+
+    double m_speed = 1.0;
+    double m_runSpeed = 1.0; // m_speed as of start(), used for the whole run
+    bool m_running = false;
+    int m_run = 0;      // start() count; tells stale handle teardown from the current run
+    int m_next = 0;     // position in m_order
+    int m_inFlight = 0;
+    int m_skipped = 0;
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QList<QPointer<RequestHandle>> m_handles;
+};
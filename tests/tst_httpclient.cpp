@@ -0,0 +1,564 @@
+#include <QHttpHeaders>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRestReply>
+#include <QTemporaryDir>
+#include <QUrlQuery>
+#include <QtTest>
+#include <memory>
+#include <optional>
+
+#include "HttpClient.h"
+#include "HttpCompression.h"
+#include "ObjectApi.h"
+#include "PagedCursor.h"
+#include "ReplayNetworkAccessManager.h"
+#include "TrafficRecorder.h"
+
+// Every test runs HttpClient over a ReplayNetworkAccessManager, so nothing
+// here touches the network
+namespace {
+
+const QUrl kBaseUrl("http://test.local/api");
+
+QUrl at(const QString& pathAndQuery)
+{
+    return QUrl("http://test.local/api/" + pathAndQuery);
+}
+
+TrafficEntry entry(const QByteArray& method, const QUrl& url, int status,
+                   const QByteArray& body, const QHttpHeaders& headers = {})
+{
+    TrafficEntry e;
+    e.method = method;
+    e.url = url;
+    e.status = status;
+    e.responseHeaders = headers;
+    e.responseBody = body;
+    return e;
+}
+
+TrafficEntry serverError(const QUrl& url)
+{
+    TrafficEntry e = entry("GET", url, 500, "{}");
+    e.reason = "Internal Server Error";
+    e.error = QNetworkReply::InternalServerError;
+    e.errorString = "Internal Server Error";
+    return e;
+}
+
+QHttpHeaders contentEncoding(const QByteArray& token)
+{
+    QHttpHeaders headers;
+    headers.append(QHttpHeaders::WellKnownHeader::ContentEncoding, token);
+    return headers;
+}
+
+QByteArray json(const QJsonArray& array)
+{
+    return QJsonDocument(array).toJson(QJsonDocument::Compact);
+}
+
+QByteArray json(const QJsonObject& object)
+{
+    return QJsonDocument(object).toJson(QJsonDocument::Compact);
+}
+
+// Large and repetitive enough for every codec to shrink it
+QByteArray samplePayload()
+{
+    QJsonArray items;
+    for (int i = 0; i < 200; ++i)
+        items.append(QJsonObject{ { "id", QString::number(i) }, { "name", "object" } });
+    return json(items);
+}
+
+std::optional<QByteArray> decode(ContentEncoding encoding, const QByteArray& data)
+{
+    QByteArray out;
+    const std::unique_ptr<StreamDecoder> decoder = StreamDecoder::create(encoding);
+    if (!decoder || !decoder->feed(data, out) || !decoder->finish())
+        return std::nullopt;
+    return out;
+}
+
+struct Response {
+    bool done = false;
+    bool success = false;
+    int status = 0;
+    QByteArray body;
+};
+
+// Callback for HttpClient calls that stores the outcome in `response`
+auto store(Response& response)
+{
+    return [&response](QRestReply& reply) {
+        response.success = reply.isSuccess();
+        response.status = reply.httpStatus();
+        response.body = reply.readBody();
+        response.done = true;
+    };
+}
+
+struct PageOutcome {
+    bool done = false;
+    QStringList items;
+    std::optional<ErrorResult> error;
+};
+
+// Shared, so a next() still pending when a check fails cannot write to a dead frame
+std::shared_ptr<PageOutcome> requestPage(PagedCursor* cursor)
+{
+    auto outcome = std::make_shared<PageOutcome>();
+    cursor->next([outcome](const QVariantList& items) {
+        for (const QVariant& item : items)
+            outcome->items.append(item.toString());
+        outcome->done = true;
+    }, [outcome](const ErrorResult& err) {
+        outcome->error = err;
+        outcome->done = true;
+    });
+    return outcome;
+}
+
+} // namespace
+
+class tst_HttpClient : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void harRoundTrip();
+    void recordsDecodedBody();
+
+    void responseDecoding_data();
+    void responseDecoding();
+    void requestCompression_data();
+    void requestCompression();
+    void emptyGzipBody();
+    void factoryQueryParameters();
+
+    void offsetLimitShortPage();
+    void offsetLimitFailedPage();
+    void cursorPaging();
+    void linkHeaderPaging();
+
+private:
+    static void addCodecRows();
+};
+
+void tst_HttpClient::addCodecRows()
+{
+    QTest::addColumn<QByteArray>("token");
+
+    QTest::newRow("gzip") << QByteArray("gzip");
+    QTest::newRow("deflate") << QByteArray("deflate");
+    QTest::newRow("zstd") << QByteArray("zstd");
+}
+
+void tst_HttpClient::harRoundTrip()
+{
+    const char raw[] = "\x00\xff\x10\x80 not utf-8";
+    const QByteArray binary(raw, sizeof(raw) - 1);
+
+    QHttpHeaders jsonHeaders;
+    jsonHeaders.append(QHttpHeaders::WellKnownHeader::ContentType, "application/json");
+
+    TrafficRecording source;
+    source.entries = {
+        entry("GET", at("objects/1"), 200, json(QJsonObject{ { "id", "1" } }), jsonHeaders),
+        entry("POST", at("objects"), 201, json(QJsonObject{ { "id", "2" } }), jsonHeaders),
+        entry("GET", at("blobs/1"), 200, binary)
+    };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+    client.setBearerToken("secret");
+
+    TrafficRecorder recorder;
+    recorder.start();
+    client.setRecorder(&recorder);
+
+    Response first, created, blob;
+    client.get("objects/1", store(first));
+    client.post("objects", json(QJsonObject{ { "name", "x" } }), store(created));
+    client.get("blobs/1", store(blob));
+    QTRY_VERIFY(first.done && created.done && blob.done);
+    QCOMPARE(blob.body, binary);
+
+    const QList<TrafficEntry>& recorded = recorder.recording().entries;
+    QCOMPARE(recorded.size(), 3);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("traffic.har");
+
+    QString error;
+    QVERIFY2(recorder.recording().save(path, &error), qPrintable(error));
+    const std::optional<TrafficRecording> loaded = TrafficRecording::load(path, &error);
+    QVERIFY2(loaded, qPrintable(error));
+    QCOMPARE(loaded->entries.size(), recorded.size());
+
+    for (qsizetype i = 0; i < recorded.size(); ++i) {
+        const TrafficEntry& want = recorded.at(i);
+        const TrafficEntry& got = loaded->entries.at(i);
+
+        QCOMPARE(got.startedAt, want.startedAt);
+        QCOMPARE(got.startOffsetMs, want.startOffsetMs);
+        QCOMPARE(got.durationMs, want.durationMs);
+        QCOMPARE(got.method, want.method);
+        QCOMPARE(got.url, want.url);
+        QCOMPARE(got.requestHeaders.toListOfPairs(), want.requestHeaders.toListOfPairs());
+        QCOMPARE(got.requestBody, want.requestBody);
+        QCOMPARE(got.status, want.status);
+        QCOMPARE(got.reason, want.reason);
+        QCOMPARE(got.responseHeaders.toListOfPairs(), want.responseHeaders.toListOfPairs());
+        QCOMPARE(got.responseBody, want.responseBody);
+        QCOMPARE(got.error, want.error);
+
+        // Credentials are redacted before they reach the file
+        QVERIFY(!got.requestHeaders.contains(QHttpHeaders::WellKnownHeader::Authorization));
+    }
+
+    // The file replays like the recording it came from
+    ReplayNetworkAccessManager replay(*loaded);
+    replay.setSpeed(0);
+    HttpClient replayClient(&replay, kBaseUrl);
+
+    Response replayed;
+    replayClient.get("blobs/1", store(replayed));
+    QTRY_VERIFY(replayed.done);
+    QVERIFY(replayed.success);
+    QCOMPARE(replayed.body, binary);
+    QCOMPARE(replay.misses(), 0);
+}
+
+void tst_HttpClient::recordsDecodedBody()
+{
+    if (!HttpCompression::isSupported(ContentEncoding::Gzip))
+        QSKIP("Built without zlib");
+
+    const QByteArray payload = samplePayload();
+    const std::optional<QByteArray> compressed = HttpCompression::compress(ContentEncoding::Gzip, payload);
+    QVERIFY(compressed);
+
+    TrafficRecording source;
+    source.entries = { entry("GET", at("objects"), 200, *compressed, contentEncoding("gzip")) };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+
+    CompressionOptions options;
+    options.acceptEncodings = { ContentEncoding::Gzip };
+    client.setCompression(options);
+
+    TrafficRecorder recorder;
+    recorder.start();
+    client.setRecorder(&recorder);
+
+    Response response;
+    client.get("objects", store(response));
+    QTRY_VERIFY(response.done);
+    QCOMPARE(response.body, payload);
+
+    // The callback saw the inflated body, so that is what gets recorded,
+    // without the headers describing the wire body
+    QCOMPARE(recorder.recording().entries.size(), 1);
+    const TrafficEntry& e = recorder.recording().entries.first();
+    QCOMPARE(e.responseBody, payload);
+    QVERIFY(!e.responseHeaders.contains(QHttpHeaders::WellKnownHeader::ContentEncoding));
+    QVERIFY(!e.responseHeaders.contains(QHttpHeaders::WellKnownHeader::ContentLength));
+}
+
+void tst_HttpClient::responseDecoding_data()
+{
+    addCodecRows();
+}
+
+void tst_HttpClient::responseDecoding()
+{
+    QFETCH(QByteArray, token);
+    const ContentEncoding encoding = HttpCompression::fromToken(token).value();
+    if (!HttpCompression::isSupported(encoding))
+        QSKIP("Codec not built in");
+
+    const QByteArray payload = samplePayload();
+    const std::optional<QByteArray> compressed = HttpCompression::compress(encoding, payload);
+    QVERIFY(compressed);
+    QVERIFY(compressed->size() < payload.size());
+
+    TrafficRecording source;
+    source.entries = { entry("GET", at("objects"), 200, *compressed, contentEncoding(token)) };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+
+    CompressionOptions options;
+    options.acceptEncodings = { encoding };
+    client.setCompression(options);
+
+    std::optional<RequestMetrics> metrics;
+    connect(&client, &HttpClient::requestCompleted, this, [&metrics](const RequestMetrics& m) { metrics = m; });
+
+    Response response;
+    client.get("objects", store(response));
+    QTRY_VERIFY(response.done);
+    QVERIFY(response.success);
+    QCOMPARE(response.body, payload);
+
+    QVERIFY(metrics);
+    QCOMPARE(metrics->method, QByteArray("GET"));
+    QCOMPARE(metrics->httpStatus, 200);
+    QCOMPARE(metrics->responseEncoding, token);
+    QCOMPARE(metrics->responseWireBytes, qint64(compressed->size()));
+    QCOMPARE(metrics->responseBytes, qint64(payload.size()));
+}
+
+void tst_HttpClient::requestCompression_data()
+{
+    addCodecRows();
+}
+
+void tst_HttpClient::requestCompression()
+{
+    QFETCH(QByteArray, token);
+    const ContentEncoding encoding = HttpCompression::fromToken(token).value();
+    if (!HttpCompression::isSupported(encoding))
+        QSKIP("Codec not built in");
+
+    TrafficRecording source;
+    source.entries = { entry("POST", at("objects"), 201, "{}") };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+
+    CompressionOptions options;
+    options.requestEncoding = encoding;
+    options.minRequestBytes = 0;
+    client.setCompression(options);
+
+    TrafficRecorder recorder;
+    recorder.start();
+    client.setRecorder(&recorder);
+
+    const QByteArray payload = samplePayload();
+    Response response;
+    client.post("objects", payload, store(response));
+    QTRY_VERIFY(response.done);
+    QVERIFY(response.success);
+
+    // What went on the wire is labelled and inflates back to the payload
+    QCOMPARE(recorder.recording().entries.size(), 1);
+    const TrafficEntry& e = recorder.recording().entries.first();
+    QCOMPARE(e.requestHeaders.combinedValue(QHttpHeaders::WellKnownHeader::ContentEncoding), token);
+    QVERIFY(e.requestBody.size() < payload.size());
+    const std::optional<QByteArray> decoded = decode(encoding, e.requestBody);
+    QVERIFY(decoded);
+    QCOMPARE(*decoded, payload);
+}
+
+void tst_HttpClient::emptyGzipBody()
+{
+    if (!HttpCompression::isSupported(ContentEncoding::Gzip))
+        QSKIP("Built without zlib");
+
+    TrafficRecording source;
+    source.entries = { entry("GET", at("objects"), 200, {}, contentEncoding("gzip")) };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+
+    CompressionOptions options;
+    options.acceptEncodings = { ContentEncoding::Gzip };
+    client.setCompression(options);
+
+    Response response;
+    client.get("objects", store(response));
+    QTRY_VERIFY(response.done);
+    QVERIFY(response.success);
+    QCOMPARE(response.status, 200);
+    QVERIFY(response.body.isEmpty());
+}
+
+void tst_HttpClient::factoryQueryParameters()
+{
+    TrafficRecording source;
+    source.entries = {
+        entry("GET", at("objects"), 200, "[]"),
+        entry("GET", at("objects?lang=en&id=7"), 200, "[]")
+    };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+
+    // The first request builds the cached template
+    Response before;
+    client.get("objects", store(before));
+    QTRY_VERIFY(before.done);
+    QVERIFY(before.success);
+
+    client.updateFactory([](QNetworkRequestFactory& factory) {
+        factory.setQueryParameters(QUrlQuery{ { "id", "7" } });
+    });
+
+    Response after;
+    client.get("objects?lang=en", store(after));
+    QTRY_VERIFY(after.done);
+    QVERIFY(after.success);
+    QCOMPARE(nam.misses(), 0);
+}
+
+void tst_HttpClient::offsetLimitShortPage()
+{
+    TrafficRecording source;
+    source.entries = {
+        entry("GET", at("objects?offset=0&limit=2"), 200, json(QJsonArray{ "a", "b" })),
+        entry("GET", at("objects?offset=2&limit=2"), 200, json(QJsonArray{ "c" })),
+        // May be prefetched before page 1 turns out to be the last one
+        entry("GET", at("objects?offset=4&limit=2"), 200, json(QJsonArray{}))
+    };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+    ObjectApi api(&client);
+
+    PageOptions options;
+    options.pageSize = 2;
+    PagedCursor* cursor = api.getPaged(options);
+
+    auto page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY(!page->error);
+    QCOMPARE(page->items, QStringList({ "a", "b" }));
+    QVERIFY(!cursor->atEnd());
+
+    page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY(!page->error);
+    QCOMPARE(page->items, QStringList({ "c" }));
+    QVERIFY(cursor->atEnd());
+
+    page = requestPage(cursor);
+    QVERIFY(page->done);
+    QVERIFY(page->error);
+    QCOMPARE(page->error->message, QString("No more pages"));
+}
+
+void tst_HttpClient::offsetLimitFailedPage()
+{
+    TrafficRecording source;
+    source.entries = {
+        entry("GET", at("objects?offset=0&limit=2"), 200, json(QJsonArray{ "a", "b" })),
+        serverError(at("objects?offset=2&limit=2")),
+        entry("GET", at("objects?offset=2&limit=2"), 200, json(QJsonArray{ "c" })),
+        entry("GET", at("objects?offset=4&limit=2"), 200, json(QJsonArray{}))
+    };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+    ObjectApi api(&client);
+
+    PageOptions options;
+    options.pageSize = 2;
+    PagedCursor* cursor = api.getPaged(options);
+
+    auto page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY(!page->error);
+    QCOMPARE(page->items, QStringList({ "a", "b" }));
+
+    // The failure belongs to page 1 and is reported there
+    page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY(page->error);
+    QCOMPARE(page->error->status, 500);
+    QVERIFY(!cursor->atEnd());
+
+    // Asking again fetches page 1 once more
+    page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY(!page->error);
+    QCOMPARE(page->items, QStringList({ "c" }));
+    QVERIFY(cursor->atEnd());
+}
+
+void tst_HttpClient::cursorPaging()
+{
+    TrafficRecording source;
+    source.entries = {
+        entry("GET", at("objects?limit=2"), 200,
+              json(QJsonObject{ { "data", QJsonArray{ "a", "b" } }, { "next_cursor", "t+1" } })),
+        // '+' in the token has to arrive as %2B, not as a space
+        entry("GET", at("objects?cursor=t%2B1&limit=2"), 200,
+              json(QJsonObject{ { "data", QJsonArray{ "c" } } }))
+    };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+    ObjectApi api(&client);
+
+    PageOptions options;
+    options.style = PageOptions::Style::Cursor;
+    options.pageSize = 2;
+    PagedCursor* cursor = api.getPaged(options);
+
+    auto page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY(!page->error);
+    QCOMPARE(page->items, QStringList({ "a", "b" }));
+
+    page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY2(!page->error, page->error ? qPrintable(page->error->message) : "");
+    QCOMPARE(page->items, QStringList({ "c" }));
+    QVERIFY(cursor->atEnd());
+    QCOMPARE(nam.misses(), 0);
+}
+
+void tst_HttpClient::linkHeaderPaging()
+{
+    QHttpHeaders link;
+    link.append(QHttpHeaders::WellKnownHeader::Link, R"(</api/objects?page=2>; rel="next", </api/objects?page=9>; rel="last")");
+
+    TrafficRecording source;
+    source.entries = {
+        entry("GET", at("objects?limit=2"), 200, json(QJsonArray{ "a", "b" }), link),
+        entry("GET", at("objects?page=2"), 200, json(QJsonArray{ "c" }))
+    };
+
+    ReplayNetworkAccessManager nam(source);
+    nam.setSpeed(0);
+    HttpClient client(&nam, kBaseUrl);
+    ObjectApi api(&client);
+
+    PageOptions options;
+    options.style = PageOptions::Style::LinkHeader;
+    options.pageSize = 2;
+    PagedCursor* cursor = api.getPaged(options);
+
+    auto page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY(!page->error);
+    QCOMPARE(page->items, QStringList({ "a", "b" }));
+
+    page = requestPage(cursor);
+    QTRY_VERIFY(page->done);
+    QVERIFY2(!page->error, page->error ? qPrintable(page->error->message) : "");
+    QCOMPARE(page->items, QStringList({ "c" }));
+    QVERIFY(cursor->atEnd());
+    QCOMPARE(nam.misses(), 0);
+}
+
+QTEST_GUILESS_MAIN(tst_HttpClient)
+
+#include "tst_httpclient.moc"